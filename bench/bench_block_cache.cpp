@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "block/block.h"
+#include "block/block_cache.h"
+#include "block/clock_cache.h"
+
+using namespace ::LSMT;
+
+/***
+ * 用法: bench_block_cache [threads] [operations per thread] [distinct blocks] [capacity]
+ * 每个线程按Zipf分布访问数据块 未命中时插入缓存 对比LRU-K与CLOCK的吞吐量和命中率
+ ***/
+
+// 预先生成Zipf分布的访问序列 避免随机数生成成为瓶颈
+static std::vector<int> generate_zipf_trace(size_t number, size_t operations, double theta, uint32_t seed) {
+    std::vector<double> cdf(number);
+    double sum = 0.0;
+    for (size_t i = 0; i < number; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+        cdf[i] = sum;
+    }
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dis(0.0, sum);
+    std::vector<int> trace(operations);
+    for (auto &block_id : trace) {
+        block_id = std::lower_bound(cdf.begin(), cdf.end(), dis(gen)) - cdf.begin();
+    }
+    return trace;
+}
+
+static void run_bench(const std::string &name, std::shared_ptr<BaseCache> cache,
+    const std::vector<std::vector<int>> &traces) {
+    auto block = std::make_shared<Block>();
+    auto beg = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (const auto &trace : traces) {
+        workers.emplace_back([&cache, &trace, &block]() {
+            for (int block_id : trace) {
+                if (cache->get(0, block_id) == nullptr) {
+                    cache->put(0, block_id, block);
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - beg).count();
+    size_t operations = traces.size() * traces.front().size();
+    std::cout << name << "\t" << operations / seconds / 1e6 << " Mops/s\t"
+              << "hit rate " << cache->hit_rate() << std::endl;
+}
+
+int main(int argc, char **argv) {
+    size_t threads    = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    size_t operations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    size_t number     = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 65536;
+    size_t capacity   = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 8192;
+    threads = std::max<size_t>(threads, 1);
+
+    std::vector<std::vector<int>> traces;
+    for (size_t i = 0; i < threads; ++i) {
+        traces.push_back(generate_zipf_trace(number, operations, 0.99, i + 1));
+    }
+
+    std::cout << "threads " << threads << ", operations/thread " << operations
+              << ", blocks " << number << ", capacity " << capacity << std::endl;
+    run_bench("lruk", std::make_shared<BlockCache>(capacity, 2), traces);
+    run_bench("lruk+tinylfu", std::make_shared<BlockCache>(capacity, 2, CacheAdmission::TINYLFU), traces);
+    run_bench("clock", std::make_shared<ClockCache>(capacity), traces);
+    run_bench("clock+tinylfu", std::make_shared<ClockCache>(capacity, CacheAdmission::TINYLFU), traces);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sst/sst.h"
+#include "sst/sst_builder.h"
+
+using namespace ::LSMT;
+
+/***
+ * 用法: bench_learned_index [key number] [lookup number] [learned error]
+ * 以大端序编码的单调数值key构建单个SST 分别不带和带学习索引
+ * 重新打开后对相同的随机key调用get_block_id 比较二分查找和学习索引预测窗口内查找的耗时
+ * 不生成过滤器 索引不拆分 只衡量数据块定位本身
+ ***/
+
+static double elapsed_ms(std::chrono::steady_clock::time_point beg) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - beg).count();
+}
+
+static std::string make_key(uint64_t number) {
+    std::string key;
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        key.push_back(static_cast<char>(number >> shift));
+    }
+    return key;
+}
+
+static std::shared_ptr<SST> build_sst(const std::string &path, size_t key_number, size_t learned_error) {
+    SSTBuilder builder(4096, false);
+    builder.set_index_partition_size(0);
+    builder.set_learned_index_error(learned_error);
+    // key间距在1到16之间变化 数据块上界不是严格等距
+    uint64_t number = 1ULL << 40;
+    for (size_t i = 0; i < key_number; ++i) {
+        number += 1 + (i * 7919) % 16;
+        builder.add(make_key(number), "v", 0);
+    }
+    auto beg = std::chrono::steady_clock::now();
+    builder.build(0, path, nullptr);
+    double ms = elapsed_ms(beg);
+
+    auto sst = SST::open(0, FileObj::open(path, false), nullptr);
+    const auto &footer = sst->get_footer();
+    std::cout << (learned_error > 0 ? "learned" : "binary") << " build\t" << sst->get_block_number() << " blocks\t"
+              << footer.filter_section_offset - footer.meta_section_offset << " index bytes\t" << ms << " ms"
+              << ((footer.features & SST_FEATURE_LEARNED_INDEX) != 0 || learned_error == 0 ? "" : "\t(model rejected)")
+              << std::endl;
+    return sst;
+}
+
+static double bench_lookup(const std::string &name, std::shared_ptr<SST> sst, const std::vector<std::string> &keys,
+                           std::vector<int64_t> &block_ids) {
+    auto beg = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        block_ids[i] = sst->get_block_id(keys[i]);
+    }
+    double ns = elapsed_ms(beg) * 1e6 / keys.size();
+    std::cout << name << " lookup\t" << keys.size() << " keys\t" << ns << " ns/lookup" << std::endl;
+    return ns;
+}
+
+int main(int argc, char **argv) {
+    size_t key_number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t lookup_number = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    size_t learned_error = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 8;
+
+    const std::string path = "bench_learned_index_path";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directory(path);
+
+    auto binary_sst = build_sst(path + "/binary", key_number, 0);
+    auto learned_sst = build_sst(path + "/learned", key_number, learned_error);
+
+    // 在整个键范围内均匀取随机key 大部分落在已有key之间 同样需要定位数据块
+    std::mt19937_64 random(42);
+    uint64_t lower = 1ULL << 40;
+    uint64_t upper = lower + key_number * 9;
+    std::vector<std::string> keys(lookup_number);
+    for (auto &key : keys) {
+        key = make_key(lower + random() % (upper - lower));
+    }
+
+    std::vector<int64_t> binary_ids(lookup_number), learned_ids(lookup_number);
+    double binary_ns = bench_lookup("binary", binary_sst, keys, binary_ids);
+    double learned_ns = bench_lookup("learned", learned_sst, keys, learned_ids);
+    std::cout << "speedup\t" << binary_ns / learned_ns << "x"
+              << (binary_ids == learned_ids ? "" : "\t(block id mismatch)") << std::endl;
+
+    std::filesystem::remove_all(path);
+    return 0;
+}
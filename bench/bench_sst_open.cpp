@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sst/sst.h"
+#include "sst/sst_builder.h"
+#include "utils/bloom_filter.h"
+#include "utils/filter.h"
+
+using namespace ::LSMT;
+
+/***
+ * 用法: bench_sst_open [sst number] [keys per sst] [legacy filter keys]
+ * 1. 解码旧格式BloomFilter过滤器段 衡量打开旧文件时过滤器的加载耗时
+ * 2. 构建若干SST后逐个重新打开 衡量启动时读取索引和过滤器的总耗时
+ ***/
+
+static double elapsed_ms(std::chrono::steady_clock::time_point beg) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - beg).count();
+}
+
+static void bench_legacy_decode(size_t key_number) {
+    BloomFilter bloom_filter(key_number, 0.01);
+    for (size_t i = 0; i < key_number; i += 16) {
+        bloom_filter.add("key" + std::to_string(i));
+    }
+    auto section = BaseFilter::encode_section(std::make_shared<BloomFilter>(bloom_filter));
+
+    const size_t repeats = 20;
+    auto beg = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (size_t i = 0; i < repeats; ++i) {
+        auto filter = BaseFilter::decode_section(section);
+        found += filter->possibly_contain("key0") ? 1 : 0;
+    }
+    double ms = elapsed_ms(beg) / repeats;
+    std::cout << "legacy bloom decode\t" << section.size() * 8 << " bits\t" << ms << " ms/filter\t"
+              << section.size() / ms / 1e3 << " MB/s" << (found == repeats ? "" : "\t(lookup mismatch)") << std::endl;
+}
+
+static void bench_sst_open(size_t sst_number, size_t key_number) {
+    const std::string path = "bench_sst_open_path";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directory(path);
+
+    for (size_t id = 0; id < sst_number; ++id) {
+        SSTBuilder builder(4096, true);
+        for (size_t i = 0; i < key_number; ++i) {
+            builder.add("key" + std::to_string(id * key_number + i), "val" + std::to_string(i), 0);
+        }
+        builder.build(id, path + "/sst_" + std::to_string(id), nullptr);
+    }
+
+    auto beg = std::chrono::steady_clock::now();
+    size_t block_number = 0;
+    for (size_t id = 0; id < sst_number; ++id) {
+        auto sst = SST::open(id, FileObj::open(path + "/sst_" + std::to_string(id), false), nullptr);
+        block_number += sst->get_block_number();
+    }
+    double ms = elapsed_ms(beg);
+    std::cout << "sst open\t" << sst_number << " ssts\t" << block_number << " blocks\t"
+              << ms << " ms\t" << ms * 1e3 / sst_number << " us/sst" << std::endl;
+
+    std::filesystem::remove_all(path);
+}
+
+int main(int argc, char **argv) {
+    size_t sst_number = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    size_t key_number = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    size_t legacy_key = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000000;
+
+    bench_legacy_decode(legacy_key);
+    bench_sst_open(sst_number, key_number);
+    return 0;
+}
@@ -1,106 +1,327 @@
+#include <algorithm>
+
 #include "block.h"
 #include "block_iterator.h"
+#include "utils/coding.h"
+#include "utils/crc32c.h"
+#include "utils/hash.h"
 
 namespace LSMT {
-Block::Block(size_t capacity) : capacity(capacity) { }
+Block::Block(size_t capacity, size_t restart_interval)
+: capacity(capacity), restart_interval(restart_interval), prefix_compressed(restart_interval > 0) { }
+
+// 读取编码中宽度为width字节的偏移数组
+static std::vector<uint32_t> read_offsets(const uint8_t *src, size_t number, size_t width) {
+    std::vector<uint32_t> offsets(number);
+    if (width == sizeof(uint32_t)) {
+        memcpy(offsets.data(), src, number * sizeof(uint32_t));
+    } else {
+        for (size_t i = 0; i < number; ++i) {
+            uint16_t offset;
+            memcpy(&offset, src + i * sizeof(uint16_t), sizeof(uint16_t));
+            offsets[i] = offset;
+        }
+    }
+    return offsets;
+}
 
 std::vector<uint8_t> Block::encode(bool with_hash) {
-    size_t total_bytes = data.size() * sizeof(uint8_t) + offsets.size() * sizeof(uint16_t) + sizeof(uint16_t);
+    if (!varint_format) {
+        throw std::runtime_error("Cannot Encode Legacy Block");
+    }
+    build_hash_index();
+    size_t total_bytes = get_cur_size();
     if (with_hash == true) {
         total_bytes += sizeof(uint32_t);
     }
     std::vector<uint8_t> encoded(total_bytes, 0);
+    uint8_t *pointer = encoded.data();
 
     // 复制元素数据段
-    memcpy(encoded.data(), data.data(), data.size() * sizeof(uint8_t));
+    memcpy(pointer, data.data(), data.size() * sizeof(uint8_t));
+    pointer += data.size();
+
+    // 复制元素偏移段或重启点段
+    if (prefix_compressed) {
+        for (uint32_t restart : restarts) {
+            memcpy(pointer, &offsets[restart], sizeof(uint32_t));
+            pointer += sizeof(uint32_t);
+        }
+        uint32_t restart_num = restarts.size();
+        memcpy(pointer, &restart_num, sizeof(uint32_t));
+        pointer += sizeof(uint32_t);
+    } else {
+        memcpy(pointer, offsets.data(), offsets.size() * sizeof(uint32_t));
+        pointer += offsets.size() * sizeof(uint32_t);
+    }
 
-    // 复制元素偏移段
-    size_t offset_pos = data.size() * sizeof(uint8_t);
-    memcpy(encoded.data() + offset_pos, offsets.data(), offsets.size() * sizeof(uint16_t));
+    // 复制哈希索引段
+    if (!hash_buckets.empty()) {
+        uint16_t bucket_num = hash_buckets.size();
+        memcpy(pointer, hash_buckets.data(), bucket_num * sizeof(uint16_t));
+        memcpy(pointer + bucket_num * sizeof(uint16_t), &bucket_num, sizeof(uint16_t));
+        pointer += (bucket_num + 1) * sizeof(uint16_t);
+    }
 
-    // 复制元素数量和哈希值
-    size_t number_pos = data.size() * sizeof(uint8_t) + offsets.size() * sizeof(uint16_t);
-    uint16_t entry_num = offsets.size();
-    memcpy(encoded.data() + number_pos, &entry_num, sizeof(uint16_t));
+    // 复制事务id基准值 元素数量 格式标记和哈希值
+    uint32_t entry_num = offsets.size();
+    if (trx_id_delta) {
+        memcpy(pointer, &base_trx_id, sizeof(uint64_t));
+        pointer += sizeof(uint64_t);
+        entry_num |= TRX_ID_DELTA_FLAG;
+    }
+    if (blob_index) {
+        entry_num |= BLOB_INDEX_FLAG;
+    }
+    memcpy(pointer, &entry_num, sizeof(uint32_t));
+    pointer += sizeof(uint32_t);
+    uint16_t flags = WIDE_FORMAT_MARK;
+    if (prefix_compressed) {
+        flags |= PREFIX_COMPRESSED_FLAG;
+    }
+    if (!hash_buckets.empty()) {
+        flags |= HASH_INDEX_FLAG;
+    }
+    if (with_hash == true) {
+        flags |= CRC32C_FLAG;
+    }
+    memcpy(pointer, &flags, sizeof(uint16_t));
     if (with_hash == true) {
-        uint32_t hash_value = std::hash<std::string_view>{}(
-            std::string_view(reinterpret_cast<const char*>(encoded.data()), encoded.size() - sizeof(uint32_t))
-        );
-        memcpy(encoded.data() + number_pos + sizeof(uint16_t), &hash_value, sizeof(uint32_t));
+        uint32_t hash_value = crc32c(encoded.data(), encoded.size() - sizeof(uint32_t));
+        memcpy(pointer + sizeof(uint16_t), &hash_value, sizeof(uint32_t));
     }
 
     return encoded;
 }
 
-std::shared_ptr<Block> Block::decode(const std::vector<uint8_t> &encoded, bool with_hash) {
+std::shared_ptr<Block> Block::decode(const std::vector<uint8_t> &encoded, bool with_hash, bool verify) {
     if (encoded.size() <= sizeof(uint16_t) || with_hash && encoded.size() <= sizeof(uint16_t) + sizeof(uint32_t)) {
         throw std::runtime_error("Encoded Data Too Small");
     }
 
     auto block = std::make_shared<Block>();
 
-    // 安全检查和复制元素数量
-    uint16_t entry_num;
+    // 安全检查和复制格式标记
+    uint16_t flags;
     size_t number_pos = encoded.size() - sizeof(uint16_t);
     if (with_hash == true) {
         number_pos = number_pos - sizeof(uint32_t);
+    }
+    memcpy(&flags, encoded.data() + number_pos, sizeof(uint16_t));
+    if (with_hash == true && verify == true) {
+        // 旧版本写入的数据块没有CRC32C标记 使用std::hash验证
         uint32_t old_hash_value;
         memcpy(&old_hash_value, encoded.data() + encoded.size() - sizeof(uint32_t), sizeof(uint32_t));
-        uint32_t new_hash_value = std::hash<std::string_view>{}(
-            std::string_view(reinterpret_cast<const char*>(encoded.data()), encoded.size() - sizeof(uint32_t))
-        );
+        uint32_t new_hash_value;
+        if ((flags & CRC32C_FLAG) != 0) {
+            new_hash_value = crc32c(encoded.data(), encoded.size() - sizeof(uint32_t));
+        } else {
+            new_hash_value = std::hash<std::string_view>{}(
+                std::string_view(reinterpret_cast<const char*>(encoded.data()), encoded.size() - sizeof(uint32_t))
+            );
+        }
         if (old_hash_value != new_hash_value) {
             throw std::runtime_error("Block Hash Verification Error");
         }
     }
-    memcpy(&entry_num, encoded.data() + number_pos, sizeof(uint16_t));
 
-    //TODO 对大端序小端序场景的适配工作
-    // 复制元素偏移段
-    size_t offset_pos = number_pos - entry_num * sizeof(uint16_t);
-    block->offsets.resize(entry_num);
-    memcpy(block->offsets.data(), encoded.data() + offset_pos, entry_num * sizeof(uint16_t));
+    // 宽格式的元素数量保存在格式标记之前 旧格式保存在格式标记的低13位
+    size_t entry_num = flags & ENTRY_NUMBER_MASK;
+    block->varint_format = entry_num == WIDE_FORMAT_MARK;
+    size_t offset_width = block->varint_format ? sizeof(uint32_t) : sizeof(uint16_t);
+    if (block->varint_format) {
+        if (number_pos < sizeof(uint32_t)) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        number_pos -= sizeof(uint32_t);
+        uint32_t entry_num32;
+        memcpy(&entry_num32, encoded.data() + number_pos, sizeof(uint32_t));
+        block->blob_index = (entry_num32 & BLOB_INDEX_FLAG) != 0;
+        block->trx_id_delta = (entry_num32 & TRX_ID_DELTA_FLAG) != 0;
+        entry_num = entry_num32 & ~(BLOB_INDEX_FLAG | TRX_ID_DELTA_FLAG);
+        if (block->trx_id_delta) {
+            if (number_pos < sizeof(uint64_t)) {
+                throw std::runtime_error("Corrupted Block");
+            }
+            number_pos -= sizeof(uint64_t);
+            memcpy(&block->base_trx_id, encoded.data() + number_pos, sizeof(uint64_t));
+        }
+    }
 
-    // 复制元素数据段
-    block->data.reserve(offset_pos);
-    block->data.assign(encoded.begin(), encoded.begin() + offset_pos);
+    // 读取哈希索引段 之后的解析把哈希索引段的起始位置视为块尾
+    if ((flags & HASH_INDEX_FLAG) != 0) {
+        uint16_t bucket_num;
+        if (number_pos < sizeof(uint16_t)) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        memcpy(&bucket_num, encoded.data() + number_pos - sizeof(uint16_t), sizeof(uint16_t));
+        if (bucket_num == 0 || (bucket_num + 1) * sizeof(uint16_t) > number_pos) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        number_pos -= (bucket_num + 1) * sizeof(uint16_t);
+        block->hash_buckets.resize(bucket_num);
+        memcpy(block->hash_buckets.data(), encoded.data() + number_pos, bucket_num * sizeof(uint16_t));
+    }
+
+    if ((flags & PREFIX_COMPRESSED_FLAG) == 0) {
+        //TODO 对大端序小端序场景的适配工作
+        // 复制元素偏移段
+        if (entry_num > number_pos / offset_width) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        size_t offset_pos = number_pos - entry_num * offset_width;
+        block->offsets = read_offsets(encoded.data() + offset_pos, entry_num, offset_width);
+
+        // 复制元素数据段
+        block->data.reserve(offset_pos);
+        block->data.assign(encoded.begin(), encoded.begin() + offset_pos);
+
+        for (uint32_t offset : block->offsets) {
+            if (offset >= offset_pos) {
+                throw std::runtime_error("Corrupted Block");
+            }
+        }
+        for (uint16_t bucket : block->hash_buckets) {
+            if (bucket < HASH_BUCKET_COLLISION && bucket >= entry_num) {
+                throw std::runtime_error("Corrupted Block");
+            }
+        }
+        return block;
+    }
+
+    // 前缀压缩格式: 读取重启点段后顺序扫描数据段 重建每个元素的偏移
+    block->prefix_compressed = true;
+    if (number_pos < offset_width) {
+        throw std::runtime_error("Corrupted Block");
+    }
+    size_t restart_num = read_offsets(encoded.data() + number_pos - offset_width, 1, offset_width)[0];
+    if (restart_num >= number_pos / offset_width) {
+        throw std::runtime_error("Corrupted Block");
+    }
+    size_t restart_pos = number_pos - (restart_num + 1) * offset_width;
+    std::vector<uint32_t> restart_offsets = read_offsets(encoded.data() + restart_pos, restart_num, offset_width);
+    block->data.assign(encoded.begin(), encoded.begin() + restart_pos);
+
+    // 元素数量不可能超过数据段字节数 避免损坏的数量导致过量分配
+    if (entry_num > restart_pos) {
+        throw std::runtime_error("Corrupted Block");
+    }
+    block->offsets.reserve(entry_num);
+    block->restarts.reserve(restart_num);
+    size_t offset = 0;
+    for (size_t i = 0; i < entry_num; ++i) {
+        if (offset >= restart_pos) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        block->offsets.push_back(offset);
+        if (block->restarts.size() < restart_num && restart_offsets[block->restarts.size()] == offset) {
+            block->restarts.push_back(i);
+        }
+        std::string_view val = block->get_val_view(offset);
+        uint64_t trx_id;
+        offset = block->parse_trx_id(val.data() + val.size() - reinterpret_cast<const char*>(block->data.data()), trx_id);
+    }
+    if (offset != restart_pos || block->restarts.size() != restart_num || (entry_num > 0 && block->restarts[0] != 0)) {
+        throw std::runtime_error("Corrupted Block");
+    }
+    for (uint16_t bucket : block->hash_buckets) {
+        if (bucket < HASH_BUCKET_COLLISION && bucket >= restart_num) {
+            throw std::runtime_error("Corrupted Block");
+        }
+    }
 
     return block;
 }
 
-bool  Block::add_entry(const std::string &key, const std::string &val, uint64_t trx_id, bool force_write) {
-    size_t total_size = key.size() + sizeof(uint16_t) + 
-                        val.size() + sizeof(uint16_t) + 
-                        sizeof(uint64_t) + sizeof(uint16_t) + get_cur_size();
+bool  Block::add_entry(const std::string &key, const std::string &val, uint64_t trx_id, bool force_write,
+        bool is_blob_index) {
+    if (!varint_format) {
+        throw std::runtime_error("Cannot Append To Legacy Block");
+    }
+    if (is_blob_index && !blob_index) {
+        throw std::runtime_error("Blob Index Is Not Enabled For Block");
+    }
+    // 开启BlobIndex时val_len的最低位标记该值是否为BlobIndex
+    uint64_t val_len = blob_index ? (static_cast<uint64_t>(val.size()) << 1) | is_blob_index : val.size();
+    // 前缀压缩格式下每隔restart_interval个元素保存一次完整key
+    bool is_restart = prefix_compressed && (restart_interval == 0 || offsets.size() % restart_interval == 0);
+    size_t shared_len = 0;
+    if (prefix_compressed && !is_restart) {
+        size_t max_len = std::min(key.size(), last_key.size());
+        while (shared_len < max_len && key[shared_len] == last_key[shared_len]) {
+            ++shared_len;
+        }
+    }
+    size_t unshared_len = key.size() - shared_len;
+    size_t key_size = prefix_compressed ? varint_length(shared_len) + varint_length(unshared_len) + unshared_len :
+                                          varint_length(key.size()) + key.size();
+    size_t index_size = prefix_compressed ? (is_restart ? sizeof(uint32_t) : 0) : sizeof(uint32_t);
+    bool is_new_key = offsets.empty() || key != last_key;
+    if (hash_index && is_new_key) {
+        index_size += get_hash_index_size(hash_entries.size() + 1) - get_hash_index_size(hash_entries.size());
+    }
+
+    // 第一个元素的事务id作为差值的基准
+    if (trx_id_delta && offsets.empty()) {
+        base_trx_id = trx_id;
+    }
+
+    // 计算Entry大小
+    size_t entry_size = key_size + varint_length(val_len) + val.size() + get_trx_id_size(trx_id);
+    size_t total_size = entry_size + index_size + get_cur_size();
     if (!force_write && total_size > capacity) {
         return false;
     }
-    // 计算Entry大小并分配空间
-    size_t entry_size = sizeof(uint16_t) + key.size() + sizeof(uint16_t) + val.size() + sizeof(uint64_t);
+    if (data.size() + entry_size > UINT32_MAX) {
+        throw std::runtime_error("Block Exceeds 4GB");
+    }
     size_t write_size = data.size();
     data.resize(write_size + entry_size);
-
-    // 写入key_len和key数据
-    uint16_t key_len = key.size();
-    memcpy(data.data() + write_size, &key_len, sizeof(uint16_t));
-    memcpy(data.data() + write_size + sizeof(uint16_t), key.data(), key_len);
-
-    write_size += sizeof(uint16_t) + key_len;
+    uint8_t *pointer = data.data() + write_size;
+
+    // 写入key_len和key数据 前缀压缩格式写入shared_len unshared_len和key中不共享的部分
+    if (prefix_compressed) {
+        pointer += encode_varint(pointer, shared_len);
+        pointer += encode_varint(pointer, unshared_len);
+        memcpy(pointer, key.data() + shared_len, unshared_len);
+        pointer += unshared_len;
+        if (is_restart) {
+            restarts.push_back(offsets.size());
+        }
+    } else {
+        pointer += encode_varint(pointer, key.size());
+        memcpy(pointer, key.data(), key.size());
+        pointer += key.size();
+    }
 
     // 写入val_len和val数据
-    uint16_t val_len = val.size();
-    memcpy(data.data() + write_size, &val_len, sizeof(uint16_t));
-    memcpy(data.data() + write_size + sizeof(uint16_t), val.data(), val_len);
-
-    write_size += sizeof(uint16_t) + val_len;
+    pointer += encode_varint(pointer, val_len);
+    memcpy(pointer, val.data(), val.size());
+    pointer += val.size();
 
     // 写入transaction id数据
-    memcpy(data.data() + write_size, &trx_id, sizeof(uint64_t));
+    if (trx_id_delta) {
+        encode_varint(pointer, zigzag_encode(trx_id - base_trx_id));
+    } else {
+        memcpy(pointer, &trx_id, sizeof(uint64_t));
+    }
 
-    write_size += sizeof(uint64_t);
+    // 记录每个key第一个版本所在的重启点 编码时生成哈希索引 重启点过多时桶中放不下 放弃哈希索引
+    if (hash_index && is_new_key) {
+        size_t restart = prefix_compressed ? restarts.size() - 1 : offsets.size();
+        if (restart < HASH_BUCKET_COLLISION) {
+            hash_entries.emplace_back(murmur_hash64(key), restart);
+        } else {
+            hash_index = false;
+            hash_entries.clear();
+        }
+    }
+    if (prefix_compressed || hash_index) {
+        last_key = key;
+    }
 
     // 写入偏移段数据
-    offsets.push_back(write_size - entry_size);
+    offsets.push_back(write_size);
     
     return true;
 }
@@ -109,12 +330,7 @@ std::string Block::get_first_key() {
     if (data.empty() || offsets.empty()) {
         return "";
     }
-    uint16_t key_len;
-    memcpy(&key_len, data.data(), sizeof(uint16_t));
-    
-    std::string key(reinterpret_cast<char*>(data.data() + sizeof(uint16_t)), key_len);
-
-    return key;
+    return std::string(get_restart_key(0));
 }
 
 size_t Block::get_offset(size_t index) const {
@@ -124,82 +340,208 @@ size_t Block::get_offset(size_t index) const {
     return offsets[index];
 }
 
-Entry Block::get_entry_by_offset(size_t offset) const {
-    Entry entry;
-    entry.key = get_key_by_offset(offset);
-    entry.val = get_val_by_offset(offset);
-    entry.trx_id = get_trx_id_by_offset(offset);
-    return entry;
+bool Block::is_prefix_compressed() const {
+    return prefix_compressed;
+}
+
+void Block::parse_key_header(size_t offset, size_t &shared_len, size_t &unshared_len, size_t &key_pos) const {
+    const uint8_t *pointer = data.data() + offset;
+    const uint8_t *limit = data.data() + data.size();
+    if (varint_format) {
+        uint64_t shared = 0, unshared = 0;
+        if (prefix_compressed) {
+            pointer = decode_varint(pointer, limit, shared);
+        }
+        pointer = pointer == nullptr ? nullptr : decode_varint(pointer, limit, unshared);
+        if (pointer == nullptr) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        shared_len = shared;
+        unshared_len = unshared;
+    } else {
+        uint16_t shared = 0, unshared;
+        size_t header_size = prefix_compressed ? 2 * sizeof(uint16_t) : sizeof(uint16_t);
+        if (offset + header_size > data.size()) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        if (prefix_compressed) {
+            memcpy(&shared, pointer, sizeof(uint16_t));
+            pointer += sizeof(uint16_t);
+        }
+        memcpy(&unshared, pointer, sizeof(uint16_t));
+        pointer += sizeof(uint16_t);
+        shared_len = shared;
+        unshared_len = unshared;
+    }
+    key_pos = pointer - data.data();
+    if (unshared_len > data.size() - key_pos) {
+        throw std::runtime_error("Corrupted Block");
+    }
+}
+
+size_t Block::get_val_pos(size_t offset) const {
+    size_t shared_len, unshared_len;
+    size_t key_pos;
+    parse_key_header(offset, shared_len, unshared_len, key_pos);
+    return key_pos + unshared_len;
+}
+
+std::string_view Block::get_restart_key(size_t restart) const {
+    // 重启点处的key完整保存在数据段中 可以直接返回视图
+    size_t shared_len, unshared_len;
+    size_t key_pos;
+    parse_key_header(offsets[get_restart_index(restart)], shared_len, unshared_len, key_pos);
+    return std::string_view(reinterpret_cast<const char*>(data.data() + key_pos), unshared_len);
+}
+
+bool Block::decode_next_key(size_t index, std::string &key) const {
+    size_t shared_len, unshared_len;
+    size_t key_pos;
+    parse_key_header(offsets[index], shared_len, unshared_len, key_pos);
+    if (shared_len > key.size()) {
+        throw std::runtime_error("Corrupted Block");
+    }
+    std::string_view unshared(reinterpret_cast<const char*>(data.data() + key_pos), unshared_len);
+    if (shared_len + unshared_len == key.size() && key.compare(shared_len, std::string::npos, unshared) == 0) {
+        return false;
+    }
+    // 复用key已有的空间 原地替换不共享的部分
+    key.resize(shared_len);
+    key.append(unshared);
+    return true;
+}
+
+std::string Block::get_key(size_t index) const {
+    // 从不超过index的最后一个重启点开始逐个还原
+    size_t restart = index;
+    if (prefix_compressed) {
+        restart = std::upper_bound(restarts.begin(), restarts.end(), index) - restarts.begin() - 1;
+    }
+    std::string key(get_restart_key(restart));
+    for (size_t i = get_restart_index(restart) + 1; i <= index; ++i) {
+        decode_next_key(i, key);
+    }
+    return key;
+}
+
+std::string_view Block::get_val_view(size_t offset) const {
+    bool is_blob_index;
+    return parse_val(offset, is_blob_index);
+}
+
+std::string_view Block::parse_val(size_t offset, bool &is_blob_index) const {
+    size_t pos = get_val_pos(offset);
+    uint64_t val_len;
+    if (varint_format) {
+        const uint8_t *pointer = decode_varint(data.data() + pos, data.data() + data.size(), val_len);
+        if (pointer == nullptr) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        pos = pointer - data.data();
+    } else {
+        uint16_t val_len16;
+        if (pos + sizeof(uint16_t) > data.size()) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        memcpy(&val_len16, data.data() + pos, sizeof(uint16_t));
+        val_len = val_len16;
+        pos += sizeof(uint16_t);
+    }
+    is_blob_index = blob_index && (val_len & 1) != 0;
+    if (blob_index) {
+        val_len >>= 1;
+    }
+    // 值之后紧跟事务id 变长编码时至少1字节
+    if (val_len + (trx_id_delta ? 1 : sizeof(uint64_t)) > data.size() - pos) {
+        throw std::runtime_error("Corrupted Block");
+    }
+    return std::string_view(reinterpret_cast<const char*>(data.data() + pos), val_len);
 }
 
-std::string Block::get_key_by_offset(size_t offset) const {
-    uint16_t key_len;
-    memcpy(&key_len, data.data() + offset, sizeof(uint16_t));
-    return std::string(reinterpret_cast<const char*>(data.data() + offset + sizeof(uint16_t)), key_len);
+bool Block::is_blob_index(size_t index) const {
+    bool is_blob_index;
+    parse_val(offsets[index], is_blob_index);
+    return is_blob_index;
 }
 
 std::string Block::get_val_by_offset(size_t offset) const {
-    uint16_t key_len, val_len;
-    memcpy(&key_len, data.data() + offset, sizeof(uint16_t));
-    offset += sizeof(uint16_t) + key_len;
-    memcpy(&val_len, data.data() + offset, sizeof(uint16_t));
-    return std::string(reinterpret_cast<const char*>(data.data() + offset + sizeof(uint16_t)), val_len);
+    return std::string(get_val_view(offset));
 }
 
 uint64_t Block::get_trx_id_by_offset(size_t offset) const {
-    uint16_t key_len, val_len;
-    memcpy(&key_len, data.data() + offset, sizeof(uint16_t));
-    offset += sizeof(uint16_t) + key_len;
-    memcpy(&val_len, data.data() + offset, sizeof(uint16_t));
-    offset += sizeof(uint16_t) + val_len;
+    std::string_view val = get_val_view(offset);
     uint64_t transaction_id;
-    memcpy(&transaction_id, data.data() + offset, sizeof(uint64_t));
+    parse_trx_id(val.data() + val.size() - reinterpret_cast<const char*>(data.data()), transaction_id);
     return transaction_id;
 }
 
-int Block::compare_key_by_offset(size_t offset, const std::string &target_key) const { //!
-    std::string source_key = get_key_by_offset(offset);
-    return source_key.compare(target_key);
+size_t Block::parse_trx_id(size_t pos, uint64_t &trx_id) const {
+    if (!trx_id_delta) {
+        if (sizeof(uint64_t) > data.size() - pos) {
+            throw std::runtime_error("Corrupted Block");
+        }
+        memcpy(&trx_id, data.data() + pos, sizeof(uint64_t));
+        return pos + sizeof(uint64_t);
+    }
+    uint64_t delta;
+    const uint8_t *pointer = decode_varint(data.data() + pos, data.data() + data.size(), delta);
+    if (pointer == nullptr) {
+        throw std::runtime_error("Corrupted Block");
+    }
+    trx_id = base_trx_id + zigzag_decode(delta);
+    return pointer - data.data();
+}
+
+size_t Block::get_trx_id_size(uint64_t trx_id) const {
+    return trx_id_delta ? varint_length(zigzag_encode(trx_id - base_trx_id)) : sizeof(uint64_t);
 }
 
-bool  Block::is_same_key(size_t index, const std::string &compare_key) const {
-    if (index > offsets.size()) {
-        return false;
-    }
-    return get_key_by_offset(offsets[index]) == compare_key;
+size_t Block::get_restart_number() const {
+    // 旧格式中每个元素都保存完整key 相当于每个元素都是重启点
+    return prefix_compressed ? restarts.size() : offsets.size();
 }
 
-int Block::adjust_idx_by_trx_id(size_t index, uint64_t trx_id) {
-    size_t offset = get_offset(index);
-    std::string key = get_key_by_offset(offset);
-    
-    if (trx_id == 0) {
-        while (index > 0 && is_same_key(index - 1, key)) {
-            index--;
-        }
-        return index;
-    } else {
-        uint64_t curr_trx_id = get_trx_id_by_offset(offset);
-        if (curr_trx_id <= trx_id) {
-            size_t prev_idx = index;
-            while (prev_idx > 0 && is_same_key(prev_idx - 1, key)) {
-                prev_idx--;
-                if (get_trx_id_by_offset(offsets[prev_idx]) > trx_id) {
-                    return prev_idx + 1;
-                }
-            }
-            return prev_idx;
+size_t Block::get_restart_index(size_t restart) const {
+    return prefix_compressed ? restarts[restart] : restart;
+}
+
+size_t Block::partition_point(const std::function<bool(std::string_view)> &before, std::string &key) const {
+    if (offsets.empty()) {
+        return 0;
+    }
+    // 在重启点上二分 找到最后一个满足before的重启点 比较时直接使用数据段中的视图
+    int lk = 0, rk = static_cast<int>(get_restart_number()) - 1;
+    while (lk <= rk) {
+        int mid = lk + (rk - lk) / 2;
+        if (before(get_restart_key(mid))) {
+            lk = mid + 1;
         } else {
-            size_t next_idx = index + 1;
-            while (next_idx < offsets.size() && is_same_key(next_idx, key)) {
-                if (get_trx_id_by_offset(offsets[next_idx]) <= trx_id) {
-                    return next_idx;
-                }
-                next_idx++;
-            }
-            return -1;
+            rk = mid - 1;
+        }
+    }
+    key.assign(get_restart_key(std::max(rk, 0)));
+    if (rk < 0) {
+        return 0;
+    }
+    // 从该重启点开始顺序扫描 在同一个缓冲区中逐步还原key直到不满足before
+    size_t index = get_restart_index(rk);
+    for (++index; index < offsets.size(); ++index) {
+        decode_next_key(index, key);
+        if (!before(key)) {
+            break;
         }
     }
+    return index;
+}
+
+size_t Block::upper_bound(const std::string &target) const {
+    std::string key;
+    return partition_point([&target](std::string_view source_key) { return source_key <= target; }, key);
+}
+
+size_t Block::lower_bound(const std::string &target) const {
+    std::string key;
+    return partition_point([&target](std::string_view source_key) { return source_key < target; }, key);
 }
 
 //TODO 调整是使用index还是offset更合适
@@ -212,26 +554,38 @@ std::optional<std::string> Block::get_val_binary(const std::string &key, uint64_
 }
 
 std::optional<size_t> Block::get_idx_binary(const std::string &key, uint64_t trx_id) {
-    if (offsets.empty()) {
+    // 定位到第一个不小于key的元素 同一个key的版本按事务id降序排列 该元素即最新的版本
+    std::string curr_key;
+    size_t index;
+    uint16_t bucket = hash_buckets.empty() ? HASH_BUCKET_COLLISION :
+                      hash_buckets[murmur_hash64(key) % hash_buckets.size()];
+    if (bucket == HASH_BUCKET_EMPTY) {
         return std::nullopt;
+    } else if (bucket != HASH_BUCKET_COLLISION) {
+        // 哈希索引命中 直接从该key所在的重启点开始顺序扫描 key的第一个版本只可能在该重启区间内
+        // 扫描到下一个重启点仍未找到时key不存在 避免不存在的key扫描到数据块末尾
+        index = get_restart_index(bucket);
+        size_t limit = bucket + 1 < get_restart_number() ? get_restart_index(bucket + 1) : offsets.size();
+        curr_key.assign(get_restart_key(bucket));
+        while (curr_key < key) {
+            if (++index >= limit) {
+                return std::nullopt;
+            }
+            decode_next_key(index, curr_key);
+        }
+    } else {
+        index = partition_point([&key](std::string_view source_key) { return source_key < key; }, curr_key);
     }
-    int lk = 0, rk = offsets.size() - 1;
-    while (lk <= rk) {
-        int mid = lk + (rk - lk) / 2;
-        size_t offset = offsets[mid];
-        int cmp = compare_key_by_offset(offset, key);
-        if (cmp == 0) {
-            auto index = adjust_idx_by_trx_id(mid, trx_id);
-            return index == -1 ? std::nullopt : std::optional<int>(index);
-        } else if (cmp < 0) {
-            lk = mid + 1;
-        } else if (cmp > 0) {
-            rk = mid - 1;
-        } else {
-            // nothing to do
+    if (index >= offsets.size() || curr_key != key) {
+        return std::nullopt;
+    }
+    // 向后找到第一个对trx_id可见的版本
+    while (trx_id != 0 && get_trx_id_by_offset(offsets[index]) > trx_id) {
+        if (++index >= offsets.size() || decode_next_key(index, curr_key)) {
+            return std::nullopt;
         }
     }
-    return std::nullopt;
+    return index;
 }
 
 size_t Block::get_max_size() const {
@@ -239,13 +593,90 @@ size_t Block::get_max_size() const {
 }
 
 size_t Block::get_cur_size() const {
-    return data.size() * sizeof(uint8_t) + offsets.size() * sizeof(uint16_t) + sizeof(uint16_t);
+    // 前缀压缩格式只编码重启点偏移和重启点数量 旧格式的偏移为2字节且没有4字节的元素数量
+    size_t index_number = prefix_compressed ? restarts.size() + 1 : offsets.size();
+    size_t offset_width = varint_format ? sizeof(uint32_t) : sizeof(uint16_t);
+    size_t extra_size = varint_format ? sizeof(uint32_t) + sizeof(uint16_t) : sizeof(uint16_t);
+    if (trx_id_delta) {
+        extra_size += sizeof(uint64_t);
+    }
+    // 构建中的块按key数量估算哈希索引大小 解码得到的块按实际桶数量计算
+    size_t hash_index_size = hash_buckets.empty() ? 0 : (hash_buckets.size() + 1) * sizeof(uint16_t);
+    if (hash_index) {
+        hash_index_size = get_hash_index_size(hash_entries.size());
+    }
+    return data.size() * sizeof(uint8_t) + index_number * offset_width + hash_index_size + extra_size;
+}
+
+void Block::set_blob_index(bool enable) {
+    if (!offsets.empty()) {
+        throw std::runtime_error("Blob Index Must Be Set On An Empty Block");
+    }
+    blob_index = enable;
+}
+
+bool Block::has_blob_index() const {
+    return blob_index;
+}
+
+void Block::set_trx_id_delta(bool enable) {
+    if (!offsets.empty()) {
+        throw std::runtime_error("Trx Id Delta Must Be Set On An Empty Block");
+    }
+    trx_id_delta = enable;
+}
+
+bool Block::has_trx_id_delta() const {
+    return trx_id_delta;
+}
+
+void Block::set_hash_index(bool enable) {
+    if (!offsets.empty()) {
+        throw std::runtime_error("Hash Index Must Be Set On An Empty Block");
+    }
+    hash_index = enable;
+}
+
+bool Block::has_hash_index() const {
+    return !hash_buckets.empty();
+}
+
+size_t Block::get_hash_index_size(size_t key_number) {
+    // 哈希桶数量按利用率0.75计算 另需2字节记录桶数量
+    if (key_number == 0) {
+        return 0;
+    }
+    return (get_bucket_number(key_number) + 1) * sizeof(uint16_t);
+}
+
+size_t Block::get_bucket_number(size_t key_number) {
+    return std::min<size_t>((key_number * 4 + 2) / 3, UINT16_MAX);
+}
+
+void Block::build_hash_index() {
+    if (!hash_index || hash_entries.empty()) {
+        return;
+    }
+    // 不同重启点的key落入同一个桶时标记为冲突 查找时回退到二分查找
+    hash_buckets.assign(get_bucket_number(hash_entries.size()), HASH_BUCKET_EMPTY);
+    for (const auto &[hash, restart] : hash_entries) {
+        uint16_t &bucket = hash_buckets[hash % hash_buckets.size()];
+        if (bucket == HASH_BUCKET_EMPTY) {
+            bucket = restart;
+        } else if (bucket != restart) {
+            bucket = HASH_BUCKET_COLLISION;
+        }
+    }
 }
 
 bool Block::is_empty() const {
     return offsets.size() == 0;
 }
 
+size_t Block::get_entry_number() const {
+    return offsets.size();
+}
+
 BlockIterator Block::begin(uint64_t trx_id) {
     return BlockIterator(shared_from_this(), 0, trx_id);
 }
@@ -257,32 +688,21 @@ BlockIterator Block::end() {
 //! 使用std::optional<std::pair<BlockIterator, BlockIterator>> + std::move替换是否可行
 std::optional<std::pair<std::shared_ptr<BlockIterator>, std::shared_ptr<BlockIterator>>>
 Block::get_monotony_predicate_iters(uint64_t trx_id, std::function<int(const std::string&)> predicate) {
-    // 获取满足predicate谓词条件的起始索引
-    int lk = 0, rk = offsets.size() - 1;
-    while (lk <= rk) {
-        int mid = lk + (rk - lk) / 2;
-        if (predicate(get_key_by_offset(offsets[mid])) <= 0) {
-            rk = mid - 1;
-        } else {
-            lk = mid + 1;
-        }
-    }
-    if (lk >= offsets.size() || predicate(get_key_by_offset(offsets[lk])) != 0) {
+    // 获取满足predicate谓词条件的起始索引 谓词接收std::string 复用同一个缓冲区避免每次比较都分配内存
+    std::string key, scratch;
+    auto call = [&predicate, &scratch](std::string_view source_key) {
+        scratch.assign(source_key.data(), source_key.size());
+        return predicate(scratch);
+    };
+    size_t lk = partition_point([&call](std::string_view source_key) { return call(source_key) > 0; }, key);
+    if (lk >= offsets.size() || call(key) != 0) {
         return std::nullopt;
     }
     auto lptr = std::make_shared<BlockIterator>(shared_from_this(), lk, trx_id);
 
     // 获取满足predicate谓词条件的末尾索引
-    lk = 0, rk = offsets.size() - 1;
-    while (lk <= rk) {
-        int mid = lk + (rk - lk) / 2;
-        if (predicate(get_key_by_offset(offsets[mid])) >= 0) {
-            lk = mid + 1;
-        } else {
-            rk = mid - 1;
-        }
-    }
-    auto rptr = std::make_shared<BlockIterator>(shared_from_this(), lk, trx_id);
+    size_t rk = partition_point([&call](std::string_view source_key) { return call(source_key) >= 0; }, key);
+    auto rptr = std::make_shared<BlockIterator>(shared_from_this(), rk, trx_id);
 
     // return std::make_optional(std::pair{lptr, rptr});  // 需要C++17支持模板参数推导
     return std::make_optional<std::pair<std::shared_ptr<BlockIterator>, std::shared_ptr<BlockIterator>>>(lptr, rptr);
@@ -8,22 +8,61 @@
 #include <optional>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 
 #include "block_iterator.h"
 
 /*** 
---------------------------------------------------------------------------------------
-|           Data Section            |            offset Section            |  Extra  |
---------------------------------------------------------------------------------------
-| Entry 1 | Entry 2 | ... | Entry N | Offset 1 | Offset 2 | ... | Offset N | Numbers |
---------------------------------------------------------------------------------------
-
-------------------------------------------------------------------------
-|                               Entry N                                |
-------------------------------------------------------------------------
-| key_len(2B) | key(key_len) | val_len(2B) | val(val_len) | trx_id(8B) |
-------------------------------------------------------------------------
+---------------------------------------------------------------------------------------------------------
+|           Data Section            |            offset Section            |            Extra           |
+---------------------------------------------------------------------------------------------------------
+| Entry 1 | Entry 2 | ... | Entry N | Offset 1 | Offset 2 | ... | Offset N | Entry Numbers(4B) | Flags(2B) |
+---------------------------------------------------------------------------------------------------------
+
+------------------------------------------------------------------------------
+|                                   Entry N                                  |
+------------------------------------------------------------------------------
+| key_len(varint) | key(key_len) | val_len(varint) | val(val_len) | trx_id(8B) |
+------------------------------------------------------------------------------
+Offset为4字节 Flags低13位全为1表示该格式 高3位为格式标记
+
+旧格式: key_len val_len和Offset均为2字节 Extra只有2字节的Numbers 高3位为格式标记 低13位为元素数量
+单个key/value和整个数据块都不能超过64KB 只在读取旧文件时解码 不再写入也不能继续追加
+
+前缀压缩格式: Flags最高位置1 偏移段只记录重启点的偏移 每隔restart_interval个元素设置一个重启点
+------------------------------------------------------------------------------------------------------
+|           Data Section            |                 Restart Section                 |    Extra     |
+------------------------------------------------------------------------------------------------------
+| Entry 1 | Entry 2 | ... | Entry N | Restart 1 | ... | Restart M | Restart Numbers(4B) | 同上         |
+------------------------------------------------------------------------------------------------------
+
+--------------------------------------------------------------------------------------------------------------
+|                                                  Entry N                                                   |
+--------------------------------------------------------------------------------------------------------------
+| shared_len(varint) | unshared_len(varint) | unshared(unshared_len) | val_len(varint) | val(val_len) | trx_id(8B) |
+--------------------------------------------------------------------------------------------------------------
+key = 前一个元素key的前shared_len字节 + unshared 重启点处shared_len恒为0 保存完整key
+查找时先在重启点上二分 再从重启点开始顺序扫描并逐步还原key
+
+哈希索引: Flags次高位置1 位于Extra之前 旧格式下每个元素都视为一个重启点
+------------------------------------------------------------
+|                     Hash Index Section                   |
+------------------------------------------------------------
+| Bucket 1(2B) | ... | Bucket K(2B) | Bucket Numbers(2B)  |
+------------------------------------------------------------
+Bucket记录哈希到该桶的key第一个版本所在的重启点 0xFFFF表示空桶 0xFFFE表示冲突
+点查询命中非冲突桶时直接从对应重启点顺序扫描 空桶说明key一定不存在 冲突时回退到二分查找
+重启点超过0xFFFD个时桶中放不下 该数据块不生成哈希索引
+
+事务id差值: Entry Numbers次高位置1 trx_id改为变长的zigzag(trx_id - base_trx_id) 通常只占1到2字节
+base_trx_id为块内第一个元素的事务id 以8字节保存在Entry Numbers之前(哈希索引段之后)
+
+BlobIndex: Entry Numbers最高位置1 val_len的最低位标记该值是否为指向Blob文件的BlobIndex 实际长度为val_len >> 1
+值较大时由SST保存BlobIndex 值本身保存在Blob文件中 见sst/blob_file.h
+
+校验和: 带校验和编码时Extra之后追加4字节校验值 覆盖之前的全部内容
+Flags第三高位置1表示校验值为CRC32C 否则为旧版本写入的std::hash截断值
 ***/
 
 namespace LSMT {
@@ -37,16 +76,54 @@ class Block : public std::enable_shared_from_this<Block> {
 public:
     Block() = default;
 
-    Block(size_t capacity);
+    // restart_interval为0时使用不压缩的旧格式
+    Block(size_t capacity, size_t restart_interval = 0);
 
     std::vector<uint8_t> encode(bool with_hash = true);
 
-    static std::shared_ptr<Block> decode(const std::vector<uint8_t> &encoded, bool with_hash = true);
+    // verify为false时跳过校验和验证 with_hash仍决定编码中是否带有校验值
+    static std::shared_ptr<Block> decode(const std::vector<uint8_t> &encoded, bool with_hash = true, bool verify = true);
 
-    bool add_entry(const std::string &key, const std::string &val, uint64_t trx_id, bool force_write);
+    bool add_entry(const std::string &key, const std::string &val, uint64_t trx_id, bool force_write,
+        bool is_blob_index = false);
 
     std::string get_first_key();
 
+    // 还原第index个元素的key 前缀压缩格式下需要从所在重启点开始扫描
+    std::string get_key(size_t index) const;
+
+    // key为第index - 1个元素的key 原地还原为第index个元素的key 返回key是否发生变化
+    bool decode_next_key(size_t index, std::string &key) const;
+
+    // 值直接指向数据段 视图在Block析构或继续写入后失效
+    std::string_view get_val_view(size_t offset) const;
+
+    // 返回第一个key大于target的元素下标 不区分版本 用于在索引分区中按首key定位数据块
+    size_t upper_bound(const std::string &target) const;
+
+    // 返回第一个key不小于target的元素下标 不区分版本 用于在短分隔符格式的索引分区中定位数据块
+    size_t lower_bound(const std::string &target) const;
+
+    bool is_prefix_compressed() const;
+
+    // 必须在写入第一个元素之前设置 开启后才能写入BlobIndex
+    void set_blob_index(bool enable);
+
+    bool has_blob_index() const;
+
+    // 第index个元素的值是否为BlobIndex
+    bool is_blob_index(size_t index) const;
+
+    // 必须在写入第一个元素之前设置 编码时为所有key生成哈希索引
+    void set_hash_index(bool enable);
+
+    bool has_hash_index() const;
+
+    // 必须在写入第一个元素之前设置 开启后事务id按相对第一个元素的差值变长编码
+    void set_trx_id_delta(bool enable);
+
+    bool has_trx_id_delta() const;
+
     size_t get_offset(size_t index) const;
 
     std::optional<std::string> get_val_binary(const std::string &key, uint64_t trx_id);
@@ -58,6 +135,8 @@ public:
     size_t get_cur_size() const;
 
     bool is_empty() const;
+
+    size_t get_entry_number() const;
     
     BlockIterator begin(uint64_t trx_id = 0);
 
@@ -70,25 +149,63 @@ public:
     iters_preffix(uint64_t trx_id, const std::string &preffix);
 
 private:
-    Entry get_entry_by_offset(size_t offset) const;
+    // 解析元素的key长度字段 越界时抛出异常
+    void parse_key_header(size_t offset, size_t &shared_len, size_t &unshared_len, size_t &key_pos) const;
+
+    size_t get_val_pos(size_t offset) const;
+
+    std::string_view parse_val(size_t offset, bool &is_blob_index) const;
 
-    std::string get_key_by_offset(size_t offset) const;
+    // 解析pos处的事务id 返回事务id之后的位置 即元素的结束位置
+    size_t parse_trx_id(size_t pos, uint64_t &trx_id) const;
+
+    size_t get_trx_id_size(uint64_t trx_id) const;
+
+    std::string_view get_restart_key(size_t restart) const;
 
     std::string get_val_by_offset(size_t offset) const;
 
     uint64_t get_trx_id_by_offset(size_t offset) const;
 
-    int adjust_idx_by_trx_id(size_t index, uint64_t trx_id);
+    size_t get_restart_number() const;
+
+    size_t get_restart_index(size_t restart) const;
+
+    void build_hash_index();
+
+    static size_t get_hash_index_size(size_t key_number);
 
-    int compare_key_by_offset(size_t offset, const std::string &target_key) const;
+    static size_t get_bucket_number(size_t key_number);
 
-    bool is_same_key(size_t index, const std::string &compare_key) const;
+    // 返回第一个不满足before的元素下标 并将其key写入key 要求before在元素序列上单调(先true后false)
+    size_t partition_point(const std::function<bool(std::string_view)> &before, std::string &key) const;
 
 private:
     friend class BlockIterator;
 
     std::vector<uint8_t> data;
-    std::vector<uint16_t> offsets;
-    size_t capacity;
+    std::vector<uint32_t> offsets;   // 每个元素的偏移 前缀压缩格式解码时顺序扫描重建
+    std::vector<uint32_t> restarts;  // 重启点对应的元素下标 仅前缀压缩格式使用
+    std::string last_key;            // 构建时上一个写入的key
+    std::vector<std::pair<uint64_t, uint16_t>> hash_entries;  // 构建时每个key的哈希及其所在重启点
+    std::vector<uint16_t> hash_buckets;
+    size_t capacity = 0;
+    size_t restart_interval = 0;
+    bool prefix_compressed = false;
+    bool hash_index = false;
+    bool varint_format = true;       // 解码旧格式数据块时为false
+    bool blob_index = false;
+    bool trx_id_delta = false;
+    uint64_t base_trx_id = 0;        // 开启事务id差值时为第一个元素的事务id
+
+    static constexpr uint16_t PREFIX_COMPRESSED_FLAG = 0x8000;
+    static constexpr uint16_t HASH_INDEX_FLAG = 0x4000;
+    static constexpr uint16_t CRC32C_FLAG = 0x2000;
+    static constexpr uint16_t ENTRY_NUMBER_MASK = 0x1FFF;
+    static constexpr uint16_t WIDE_FORMAT_MARK = 0x1FFF;  // 旧格式64KB内最多4681个元素 不会出现该值
+    static constexpr uint32_t BLOB_INDEX_FLAG = 0x80000000;
+    static constexpr uint32_t TRX_ID_DELTA_FLAG = 0x40000000;
+    static constexpr uint16_t HASH_BUCKET_EMPTY = 0xFFFF;
+    static constexpr uint16_t HASH_BUCKET_COLLISION = 0xFFFE;
 };
 } // LOG STRUCTURED MERGE TREE
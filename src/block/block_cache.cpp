@@ -1,28 +1,74 @@
 #include "block_cache.h"
 
 namespace LSMT {
-BlockCache::BlockCache(size_t capacity, size_t k) : capacity(capacity), K(k) {
+CachePriority to_cache_priority(const std::string &name) {
+    if (name == "low") {
+        return CachePriority::LOW;
+    } else if (name == "bypass") {
+        return CachePriority::BYPASS;
+    } else {
+        return CachePriority::NORMAL;
+    }
+}
+
+CacheAdmission to_cache_admission(const std::string &name) {
+    if (name == "tinylfu") {
+        return CacheAdmission::TINYLFU;
+    } else {
+        return CacheAdmission::NONE;
+    }
+}
+
+CachePrepopulate to_cache_prepopulate(const std::string &name) {
+    if (name == "all") {
+        return CachePrepopulate::ALL;
+    } else if (name == "hot") {
+        return CachePrepopulate::HOT;
+    } else {
+        return CachePrepopulate::NONE;
+    }
+}
+
+BlockCache::BlockCache(size_t capacity, size_t k, CacheAdmission admission)
+: capacity(capacity), K(k), admission(admission) {
+    if (admission == CacheAdmission::TINYLFU) {
+        sketch = std::make_unique<CountMinSketch>(capacity);
+    }
     hit_requests = 0;
     sum_requests = 0;
 }
 
 BlockCache::~BlockCache() = default;
 
-std::shared_ptr<Block> BlockCache::get(int sst_id, int block_id) {
+std::shared_ptr<Block> BlockCache::get(int sst_id, int block_id, CachePriority priority) {
     std::lock_guard<std::mutex> lock(cache_mutex);
 
     auto key = std::make_pair(sst_id, block_id);
 
+    // 只有正常读取计入访问频率 扫描和合并读取不影响热点统计
+    if (sketch != nullptr && priority == CachePriority::NORMAL) {
+        sketch->increment(hash_key(sst_id, block_id));
+    }
+
     sum_requests++;
-    if (hashmap.find(key) == hashmap.end()) {
+    auto it = hashmap.find(key);
+    if (it == hashmap.end()) {
         return nullptr;
     }
     hit_requests++;
-    update_access_count(hashmap[key]);
-    return hashmap[key]->block;
+    auto block = it->second->block;
+    if (priority == CachePriority::NORMAL) {
+        update_access_count(it->second);
+    }
+    return block;
 }
 
-void BlockCache::put(int sst_id, int block_id, std::shared_ptr<Block> block) {
+void BlockCache::put(int sst_id, int block_id, std::shared_ptr<Block> block, CachePriority priority) {
+    // 容量为0时没有可淘汰的块 不缓存任何块
+    if (priority == CachePriority::BYPASS || capacity == 0) {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(cache_mutex);
 
     auto key = std::make_pair(sst_id, block_id);
@@ -30,21 +76,56 @@ void BlockCache::put(int sst_id, int block_id, std::shared_ptr<Block> block) {
     if (hashmap.find(key) != hashmap.end()) { return; }
 
     if (hashmap.size() >= capacity) {
+        if (priority != CachePriority::WARM && !admit(sst_id, block_id)) {
+            return;
+        }
         if (!lru_cache_less_k.empty()) {
-            int last_sst_id = lru_cache_less_k.back().sst_id;
-            int last_blk_id = lru_cache_less_k.back().blk_id;
-            hashmap.erase(std::make_pair(last_sst_id, last_blk_id));
-            lru_cache_less_k.pop_back();
+            evict(lru_cache_less_k);
         } else {
-            int last_sst_id = lru_cache_more_k.back().sst_id;
-            int last_blk_id = lru_cache_more_k.back().blk_id;
-            hashmap.erase(std::make_pair(last_sst_id, last_blk_id));
-            lru_cache_more_k.pop_back();
+            evict(lru_cache_more_k);
         }
     }
     CacheItem item{sst_id, block_id, 1, block};
-    lru_cache_less_k.push_front(item);
-    hashmap[key] = lru_cache_less_k.begin();
+    if (priority == CachePriority::LOW) {
+        lru_cache_less_k.push_back(item);
+        hashmap[key] = std::prev(lru_cache_less_k.end());
+    } else {
+        lru_cache_less_k.push_front(item);
+        hashmap[key] = lru_cache_less_k.begin();
+    }
+    sst_blocks[sst_id].insert(block_id);
+}
+
+void BlockCache::erase_sst(int sst_id) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    auto sst_it = sst_blocks.find(sst_id);
+    if (sst_it == sst_blocks.end()) {
+        return;
+    }
+    for (int block_id : sst_it->second) {
+        auto it = hashmap.find(std::make_pair(sst_id, block_id));
+        if (it == hashmap.end()) {
+            continue;
+        }
+        if (it->second->access_count < K) {
+            lru_cache_less_k.erase(it->second);
+        } else {
+            lru_cache_more_k.erase(it->second);
+        }
+        hashmap.erase(it);
+    }
+    sst_blocks.erase(sst_it);
+}
+
+std::vector<int> BlockCache::cached_blocks(int sst_id) const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    auto sst_it = sst_blocks.find(sst_id);
+    if (sst_it == sst_blocks.end()) {
+        return {};
+    }
+    return std::vector<int>(sst_it->second.begin(), sst_it->second.end());
 }
 
 double BlockCache::hit_rate() const {
@@ -52,6 +133,15 @@ double BlockCache::hit_rate() const {
     return sum_requests == 0 ? 0.0 : static_cast<double>(hit_requests) / sum_requests;
 }
 
+size_t BlockCache::get_capacity() const {
+    return capacity;
+}
+
+size_t BlockCache::get_usage() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return hashmap.size();
+}
+
 void BlockCache::update_access_count(std::list<CacheItem>::iterator it) {
     it->access_count++;
 
@@ -66,4 +156,34 @@ void BlockCache::update_access_count(std::list<CacheItem>::iterator it) {
         // nothing to do
     }
 }
-} // LOG STRUCTURED MERGE TREE
\ No newline at end of file
+
+void BlockCache::evict(std::list<CacheItem> &lru_cache) {
+    int last_sst_id = lru_cache.back().sst_id;
+    int last_blk_id = lru_cache.back().blk_id;
+    hashmap.erase(std::make_pair(last_sst_id, last_blk_id));
+    lru_cache.pop_back();
+
+    auto sst_it = sst_blocks.find(last_sst_id);
+    sst_it->second.erase(last_blk_id);
+    if (sst_it->second.empty()) {
+        sst_blocks.erase(sst_it);
+    }
+}
+
+bool BlockCache::admit(int sst_id, int block_id) const {
+    if (sketch == nullptr) {
+        return true;
+    }
+    // TinyLFU: 候选块的访问频率必须高于淘汰块才允许替换
+    const CacheItem &victim = lru_cache_less_k.empty() ? lru_cache_more_k.back() : lru_cache_less_k.back();
+    return sketch->estimate(hash_key(sst_id, block_id)) > sketch->estimate(hash_key(victim.sst_id, victim.blk_id));
+}
+
+uint64_t BlockCache::hash_key(int sst_id, int block_id) {
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(sst_id)) << 32) | static_cast<uint32_t>(block_id);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+} // LOG STRUCTURED MERGE TREE
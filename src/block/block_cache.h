@@ -4,13 +4,43 @@
 #include <list>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "block.h"
+#include "utils/count_min_sketch.h"
 
 namespace LSMT {
+// 缓存填充优先级: NORMAL正常插入 LOW插入冷端优先淘汰 BYPASS不插入缓存 WARM预热插入热端且跳过准入检查
+enum class CachePriority {
+    NORMAL,
+    LOW,
+    BYPASS,
+    WARM,
+};
+
+// 缓存准入策略: NONE无条件准入 TINYLFU基于访问频率准入
+enum class CacheAdmission {
+    NONE,
+    TINYLFU,
+};
+
+// 新生成SST数据块的缓存预热策略: NONE不预热 ALL预热全部数据块 HOT只预热输入SST中已缓存键范围的数据块
+enum class CachePrepopulate {
+    NONE,
+    ALL,
+    HOT,
+};
+
+CachePriority to_cache_priority(const std::string &name);
+
+CacheAdmission to_cache_admission(const std::string &name);
+
+CachePrepopulate to_cache_prepopulate(const std::string &name);
+
 struct CacheItem {
     int sst_id;
     int blk_id;
@@ -35,27 +65,67 @@ struct PairEqual {
     }
 };
 
-class BlockCache {
+class BaseCache {
+public:
+    virtual ~BaseCache() = default;
+
+    virtual std::shared_ptr<Block> get(int sst_id, int block_id, CachePriority priority = CachePriority::NORMAL) = 0;
+
+    virtual void put(int sst_id, int block_id, std::shared_ptr<Block> block,
+        CachePriority priority = CachePriority::NORMAL) = 0;
+
+    virtual void erase_sst(int sst_id) = 0;
+
+    virtual std::vector<int> cached_blocks(int sst_id) const = 0;
+
+    virtual double hit_rate() const = 0;
+
+    virtual size_t get_capacity() const = 0;
+
+    // 当前已缓存的数据块数量
+    virtual size_t get_usage() const = 0;
+};
+
+// LRU-K缓存: 访问次数少于K次的数据块和达到K次的数据块分别维护LRU链表
+class BlockCache : public BaseCache {
 public:
-    BlockCache(size_t capacity, size_t k);
+    BlockCache(size_t capacity, size_t k, CacheAdmission admission = CacheAdmission::NONE);
 
     ~BlockCache();
 
-    std::shared_ptr<Block> get(int sst_id, int block_id);
+    std::shared_ptr<Block> get(int sst_id, int block_id, CachePriority priority = CachePriority::NORMAL) override;
+
+    void put(int sst_id, int block_id, std::shared_ptr<Block> block,
+        CachePriority priority = CachePriority::NORMAL) override;
 
-    void put(int sst_id, int block_id, std::shared_ptr<Block> block);
+    void erase_sst(int sst_id) override;
 
-    double hit_rate() const;
+    std::vector<int> cached_blocks(int sst_id) const override;
+
+    double hit_rate() const override;
+
+    size_t get_capacity() const override;
+
+    size_t get_usage() const override;
+
+    static uint64_t hash_key(int sst_id, int block_id);
 
 private:
     void update_access_count(std::list<CacheItem>::iterator it);
+
+    bool admit(int sst_id, int block_id) const;
+
+    void evict(std::list<CacheItem> &lru_cache);
 private:
     size_t capacity;
     size_t K;
+    CacheAdmission admission;
+    std::unique_ptr<CountMinSketch> sketch;
     mutable std::mutex cache_mutex;
     std::list<CacheItem> lru_cache_more_k;
     std::list<CacheItem> lru_cache_less_k;
     std::unordered_map<std::pair<int, int>, std::list<CacheItem>::iterator, PairHash, PairEqual> hashmap;
+    std::unordered_map<int, std::unordered_set<int>> sst_blocks;  // 每个SST已缓存的数据块索引
     mutable size_t hit_requests;
     mutable size_t sum_requests;
 };
@@ -6,8 +6,10 @@ BlockIterator::BlockIterator() : block(nullptr), curr_index(0), trx_id(0) { }
 
 BlockIterator::BlockIterator(std::shared_ptr<Block> blk, size_t index, uint64_t trx_id) 
 : block(blk), curr_index(index), trx_id(trx_id), cached_kvpair(std::nullopt) {
+    if (curr_index < block->offsets.size()) {
+        curr_key = block->get_key(curr_index);
+    }
     skip_by_trx_id();
-    update_current();
 }
 
 BlockIterator::BlockIterator(std::shared_ptr<Block> blk, const std::string &key, uint64_t trx_id) 
@@ -15,12 +17,14 @@ BlockIterator::BlockIterator(std::shared_ptr<Block> blk, const std::string &key,
     auto index = blk->get_idx_binary(key, trx_id);
     if (index.has_value()) {
         curr_index = index.value();
+        curr_key = key;
     } else {
         curr_index = blk->offsets.size();
     }
 }
 
 const std::pair<std::string, std::string>* BlockIterator::operator->() const {
+    update_current();
     return &(cached_kvpair.value());
 }
 
@@ -28,21 +32,33 @@ std::pair<std::string, std::string> BlockIterator::operator*() const {
     if (!block || curr_index >= block->offsets.size()) {
         throw std::out_of_range("Iterator out of offset range");
     }
-    if (!cached_kvpair.has_value()) {
-        size_t offset = block->get_offset(curr_index);
-        cached_kvpair = std::make_pair(block->get_key_by_offset(offset), block->get_val_by_offset(offset));
-    }
+    update_current();
     return cached_kvpair.value();
 }
 
-BlockIterator &BlockIterator::operator++() {
-    Entry entry = block->get_entry_by_offset(block->get_offset(curr_index));
-    while (block && curr_index < block->offsets.size() 
-        && entry.key == block->get_entry_by_offset(block->get_offset(curr_index)).key) {
-        ++curr_index;
+std::string_view BlockIterator::key() const {
+    if (!block || curr_index >= block->offsets.size()) {
+        throw std::out_of_range("Iterator out of offset range");
     }
+    return curr_key;
+}
+
+std::string_view BlockIterator::value() const {
+    if (!block || curr_index >= block->offsets.size()) {
+        throw std::out_of_range("Iterator out of offset range");
+    }
+    return block->get_val_view(block->get_offset(curr_index));
+}
+
+bool BlockIterator::is_blob_index() const {
+    return block && curr_index < block->offsets.size() && block->is_blob_index(curr_index);
+}
+
+BlockIterator &BlockIterator::operator++() {
+    // 跳过同一个key的其余版本
+    while (block && curr_index < block->offsets.size() && !advance()) { }
     skip_by_trx_id();
-    update_current();
+    cached_kvpair = std::nullopt;
     return *this;
 }
 
@@ -74,10 +90,18 @@ bool BlockIterator::is_vld() const {
 }
 
 void BlockIterator::update_current() const {
-    if (curr_index < block->offsets.size()) {
-        size_t offset = block->get_offset(curr_index);
-        cached_kvpair = std::make_pair(block->get_key_by_offset(offset), block->get_val_by_offset(offset));
+    // 只在通过operator*或operator->访问时才拷贝键值对
+    if (!cached_kvpair.has_value() && curr_index < block->offsets.size()) {
+        cached_kvpair = std::make_pair(curr_key, block->get_val_by_offset(block->get_offset(curr_index)));
+    }
+}
+
+bool BlockIterator::advance() {
+    ++curr_index;
+    if (curr_index >= block->offsets.size()) {
+        return true;
     }
+    return block->decode_next_key(curr_index, curr_key);
 }
 
 IteratorType BlockIterator::get_iterator_type() const {
@@ -94,7 +118,7 @@ void BlockIterator::skip_by_trx_id() {
         if (block->get_trx_id_by_offset(offset) <= trx_id) {
             break;
         }
-        ++curr_index;
+        advance();
     }
 }
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
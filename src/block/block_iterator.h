@@ -5,6 +5,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 
 #include "iterator/iterator.h"
@@ -24,6 +25,13 @@ public:
     
     std::pair<std::string, std::string> operator*() const override;
 
+    // 不拷贝的键值视图 在迭代器移动后失效
+    std::string_view key() const;
+
+    std::string_view value() const;
+
+    bool is_blob_index() const override;
+
     BlockIterator &operator++() override;
 
     BlockIterator operator++(int) = delete;
@@ -45,10 +53,14 @@ private:
 
     void skip_by_trx_id();
 
+    // 前进到下一个元素 并由当前key原地还原下一个元素的key 返回key是否发生变化
+    bool advance();
+
 private:
     std::shared_ptr<Block> block;
     size_t curr_index;
     uint64_t trx_id;
+    std::string curr_key;
     mutable std::optional<std::pair<std::string, std::string>> cached_kvpair;
 };
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
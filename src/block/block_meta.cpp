@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <stdexcept>
 
 #include "block_meta.h"
+#include "utils/coding.h"
+#include "utils/crc32c.h"
 
 namespace LSMT {
 BlockMeta::BlockMeta() : offset(0), fkey(""), lkey("") { }
@@ -8,41 +11,66 @@ BlockMeta::BlockMeta() : offset(0), fkey(""), lkey("") { }
 BlockMeta::BlockMeta(size_t offset, const std::string &first_key, const std::string &last_key)
     : offset(offset), fkey(first_key), lkey(last_key) { }
 
-void BlockMeta::encode_meta(const std::vector<BlockMeta> &meta_entries, std::vector<uint8_t> &meta_data) {
+void BlockMeta::encode_meta(const std::vector<BlockMeta> &meta_entries, std::vector<uint8_t> &meta_data,
+                            bool shorten) {
+    // 短分隔符格式只保存SST首key和每个数据块的separator
+    std::string first_key;
+    std::vector<std::string> separators;
+    if (shorten) {
+        first_key = meta_entries.empty() ? "" : meta_entries.front().fkey;
+        separators.reserve(meta_entries.size());
+        for (size_t i = 0; i < meta_entries.size(); ++i) {
+            separators.push_back(i + 1 < meta_entries.size()
+                ? shortest_separator(meta_entries[i].lkey, meta_entries[i + 1].fkey) : meta_entries[i].lkey);
+        }
+    }
+
     size_t total_size = sizeof(uint32_t) + sizeof(uint32_t);  // entry number + hash value
-    for (const auto &entry : meta_entries) {
-        total_size += sizeof(uint32_t) + sizeof(uint16_t) + entry.fkey.size() + sizeof(uint16_t) + entry.lkey.size();
+    if (shorten) {
+        total_size += varint_length(first_key.size()) + first_key.size();
+        for (const auto &separator : separators) {
+            total_size += sizeof(uint64_t) + varint_length(separator.size()) + separator.size();
+        }
+    } else {
+        for (const auto &entry : meta_entries) {
+            total_size += sizeof(uint64_t) + varint_length(entry.fkey.size()) + entry.fkey.size() +
+                          varint_length(entry.lkey.size()) + entry.lkey.size();
+        }
     }
     meta_data.resize(total_size);
     uint8_t* pointer = meta_data.data();
 
+    auto write_key = [&pointer](const std::string &key) {
+        pointer += encode_varint(pointer, key.size());
+        memcpy(pointer, key.data(), key.size());
+        pointer += key.size();
+    };
+
     // 写入Meta Entry数量
-    uint32_t entry_number = meta_entries.size();
+    uint32_t entry_number = meta_entries.size() | CRC32C_FLAG | WIDE_FORMAT_FLAG | (shorten ? SEPARATOR_FLAG : 0);
     memcpy(pointer, &entry_number, sizeof(uint32_t));
     pointer += sizeof(uint32_t);
+    if (shorten) {
+        write_key(first_key);
+    }
 
     // 写入Meta Entry数据
-    for (const auto &entry : meta_entries) {
-        uint32_t offset32 = static_cast<uint32_t>(entry.offset);
-        memcpy(pointer, &offset32, sizeof(uint32_t));
-        pointer += sizeof(uint32_t);
-
-        uint16_t fkey_len = entry.fkey.size();
-        memcpy(pointer, &fkey_len, sizeof(uint16_t));
-        memcpy(pointer + sizeof(uint16_t), entry.fkey.data(), fkey_len);
-        pointer += sizeof(uint16_t) + fkey_len;
+    for (size_t i = 0; i < meta_entries.size(); ++i) {
+        uint64_t offset64 = meta_entries[i].offset;
+        memcpy(pointer, &offset64, sizeof(uint64_t));
+        pointer += sizeof(uint64_t);
 
-        uint16_t lkey_len = entry.lkey.size();
-        memcpy(pointer, &lkey_len, sizeof(uint16_t));
-        memcpy(pointer + sizeof(uint16_t), entry.lkey.data(), lkey_len);
-        pointer += sizeof(uint16_t) + lkey_len;
+        if (shorten) {
+            write_key(separators[i]);
+        } else {
+            write_key(meta_entries[i].fkey);
+            write_key(meta_entries[i].lkey);
+        }
     }
 
     // 写入Meta Entry哈希值
     size_t meta_size = total_size - sizeof(uint32_t) - sizeof(uint32_t);
-    uint32_t hash_value = std::hash<std::string_view>{}(
-        std::string_view(reinterpret_cast<const char*>(pointer - meta_size), meta_size)
-    );
+    uint32_t hash_value = crc32c(pointer - meta_size, meta_size);
     memcpy(pointer, &hash_value, sizeof(uint32_t));
 }
 
@@ -51,31 +79,73 @@ void BlockMeta::decode_meta(const std::vector<uint8_t> &meta_data, std::vector<B
         throw std::runtime_error("Invalid Metadata Size");
     }
     const uint8_t* pointer = meta_data.data();
+    const uint8_t* limit = meta_data.data() + meta_data.size() - sizeof(uint32_t);
     
     // 读取Meta Entry数量
     uint32_t entry_number;
     memcpy(&entry_number, pointer, sizeof(uint32_t));
     pointer += sizeof(uint32_t);
+    bool is_crc32c = (entry_number & CRC32C_FLAG) != 0;
+    bool is_wide = (entry_number & WIDE_FORMAT_FLAG) != 0;
+    bool is_shortened = (entry_number & SEPARATOR_FLAG) != 0;
+    entry_number &= ~FLAG_MASK;
+
+    // 读取一个key 宽格式的长度为varint 旧格式为2字节
+    auto read_key = [&pointer, limit, is_wide](std::string &key) {
+        uint64_t key_len = 0;
+        if (is_wide) {
+            pointer = decode_varint(pointer, limit, key_len);
+        } else if (limit - pointer >= static_cast<ptrdiff_t>(sizeof(uint16_t))) {
+            uint16_t key_len16;
+            memcpy(&key_len16, pointer, sizeof(uint16_t));
+            key_len = key_len16;
+            pointer += sizeof(uint16_t);
+        } else {
+            pointer = nullptr;
+        }
+        if (pointer == nullptr || key_len > static_cast<uint64_t>(limit - pointer)) {
+            throw std::runtime_error("Corrupted Meta Data");
+        }
+        key.assign(reinterpret_cast<const char *>(pointer), key_len);
+        pointer += key_len;
+    };
+
+    std::string first_key;
+    if (is_shortened) {
+        read_key(first_key);
+    }
 
     // 读取Meta Entry数据
+    size_t offset_width = is_wide ? sizeof(uint64_t) : sizeof(uint32_t);
+    if (entry_number > meta_data.size() / offset_width) {
+        throw std::runtime_error("Corrupted Meta Data");
+    }
     meta_entries.resize(entry_number);
     for (uint32_t i = 0; i < entry_number; ++i) {
-        BlockMeta entry;
-
-        uint32_t offset32;
-        memcpy(&offset32, pointer, sizeof(uint32_t));
-        meta_entries[i].offset = offset32;
-        pointer += sizeof(uint32_t);
-
-        uint16_t fkey_len;
-        memcpy(&fkey_len, pointer, sizeof(uint16_t));
-        meta_entries[i].fkey.assign(reinterpret_cast<const char *>(pointer + sizeof(uint16_t)), fkey_len);
-        pointer += sizeof(uint16_t) + fkey_len;
+        if (limit - pointer < static_cast<ptrdiff_t>(offset_width)) {
+            throw std::runtime_error("Corrupted Meta Data");
+        }
+        if (is_wide) {
+            uint64_t offset64;
+            memcpy(&offset64, pointer, sizeof(uint64_t));
+            meta_entries[i].offset = offset64;
+        } else {
+            uint32_t offset32;
+            memcpy(&offset32, pointer, sizeof(uint32_t));
+            meta_entries[i].offset = offset32;
+        }
+        pointer += offset_width;
 
-        uint16_t lkey_len;
-        memcpy(&lkey_len, pointer, sizeof(uint16_t));
-        meta_entries[i].lkey.assign(reinterpret_cast<const char *>(pointer + sizeof(uint16_t)), lkey_len);
-        pointer += sizeof(uint16_t) + lkey_len;
+        if (is_shortened) {
+            meta_entries[i].fkey = i == 0 ? first_key : "";
+            read_key(meta_entries[i].lkey);
+        } else {
+            read_key(meta_entries[i].fkey);
+            read_key(meta_entries[i].lkey);
+        }
+    }
+    if (pointer != limit) {
+        throw std::runtime_error("Corrupted Meta Data");
     }
 
     // 验证Meta Entry哈希值
@@ -83,11 +153,134 @@ void BlockMeta::decode_meta(const std::vector<uint8_t> &meta_data, std::vector<B
     memcpy(&old_hash, pointer, sizeof(uint32_t));
 
     size_t meta_size = meta_data.size() - sizeof(uint32_t) - sizeof(uint32_t);
-    new_hash = std::hash<std::string_view>{}(
-        std::string_view(reinterpret_cast<const char *>(pointer - meta_size), meta_size)
-    );
+    if (is_crc32c) {
+        new_hash = crc32c(pointer - meta_size, meta_size);
+    } else {
+        new_hash = std::hash<std::string_view>{}(
+            std::string_view(reinterpret_cast<const char *>(pointer - meta_size), meta_size)
+        );
+    }
     if (new_hash != old_hash) {
         throw std::runtime_error("Meta Data Hash Value Error");
     }
 }
+
+std::string BlockMeta::encode_handle(size_t offset, size_t size, const std::string &last_key) {
+    std::vector<uint8_t> handle;
+    put_varint(handle, offset);
+    put_varint(handle, size);
+    handle.insert(handle.end(), last_key.begin(), last_key.end());
+    return std::string(handle.begin(), handle.end());
+}
+
+BlockMeta BlockMeta::decode_handle(const std::string &first_key, std::string_view handle, size_t &size) {
+    const uint8_t *pointer = reinterpret_cast<const uint8_t *>(handle.data());
+    const uint8_t *limit = pointer + handle.size();
+    uint64_t offset64, size64;
+    pointer = decode_varint(pointer, limit, offset64);
+    pointer = pointer == nullptr ? nullptr : decode_varint(pointer, limit, size64);
+    if (pointer == nullptr) {
+        throw std::runtime_error("Corrupted Index Partition");
+    }
+    size = size64;
+    return BlockMeta(offset64, first_key, std::string(reinterpret_cast<const char *>(pointer), limit - pointer));
+}
+
+std::string BlockMeta::shortest_separator(const std::string &start, const std::string &limit) {
+    // 跳过公共前缀 一方是另一方的前缀时无法缩短
+    size_t min_size = std::min(start.size(), limit.size());
+    size_t diff = 0;
+    while (diff < min_size && start[diff] == limit[diff]) {
+        ++diff;
+    }
+    if (diff >= min_size) {
+        return start;
+    }
+    // 第一个不同字节加1后仍小于limit对应字节时 截断到该字节即为更短的分隔符
+    uint8_t byte = static_cast<uint8_t>(start[diff]);
+    if (byte < 0xff && byte + 1 < static_cast<uint8_t>(limit[diff])) {
+        std::string separator = start.substr(0, diff + 1);
+        separator[diff] = static_cast<char>(byte + 1);
+        return separator;
+    }
+    // 只差1时保留该字节 在其后找到第一个可以加1的字节截断 结果仍大于start且小于limit
+    for (size_t i = diff + 1; i + 1 < start.size(); ++i) {
+        if (static_cast<uint8_t>(start[i]) < 0xff) {
+            std::string separator = start.substr(0, i + 1);
+            ++separator[i];
+            return separator;
+        }
+    }
+    return start;
+}
+
+void IndexPartition::encode_partitions(const std::vector<IndexPartition> &partitions, std::vector<uint8_t> &meta_data) {
+    meta_data.resize(sizeof(uint32_t));
+    uint32_t entry_number = partitions.size() | BlockMeta::CRC32C_FLAG | BlockMeta::WIDE_FORMAT_FLAG;
+    memcpy(meta_data.data(), &entry_number, sizeof(uint32_t));
+    for (const auto &partition : partitions) {
+        put_varint(meta_data, partition.offset);
+        put_varint(meta_data, partition.size);
+        put_varint(meta_data, partition.block_number);
+        put_varint(meta_data, partition.fkey.size());
+        meta_data.insert(meta_data.end(), partition.fkey.begin(), partition.fkey.end());
+        put_varint(meta_data, partition.lkey.size());
+        meta_data.insert(meta_data.end(), partition.lkey.begin(), partition.lkey.end());
+    }
+    uint32_t hash_value = crc32c(meta_data.data() + sizeof(uint32_t), meta_data.size() - sizeof(uint32_t));
+    meta_data.resize(meta_data.size() + sizeof(uint32_t));
+    memcpy(meta_data.data() + meta_data.size() - sizeof(uint32_t), &hash_value, sizeof(uint32_t));
+}
+
+void IndexPartition::decode_partitions(const std::vector<uint8_t> &meta_data, std::vector<IndexPartition> &partitions) {
+    if (meta_data.size() < sizeof(uint32_t) + sizeof(uint32_t)) {
+        throw std::runtime_error("Invalid Metadata Size");
+    }
+    const uint8_t *pointer = meta_data.data() + sizeof(uint32_t);
+    const uint8_t *limit = meta_data.data() + meta_data.size() - sizeof(uint32_t);
+    uint32_t hash_value;
+    memcpy(&hash_value, limit, sizeof(uint32_t));
+    if (hash_value != crc32c(pointer, limit - pointer)) {
+        throw std::runtime_error("Meta Data Hash Value Error");
+    }
+
+    uint32_t entry_number;
+    memcpy(&entry_number, meta_data.data(), sizeof(uint32_t));
+    entry_number &= ~BlockMeta::FLAG_MASK;
+    if (entry_number > static_cast<size_t>(limit - pointer)) {
+        throw std::runtime_error("Corrupted Meta Data");
+    }
+
+    auto read_varint = [&pointer, limit]() {
+        uint64_t value;
+        pointer = decode_varint(pointer, limit, value);
+        if (pointer == nullptr) {
+            throw std::runtime_error("Corrupted Meta Data");
+        }
+        return value;
+    };
+    auto read_key = [&pointer, limit, &read_varint](std::string &key) {
+        uint64_t key_len = read_varint();
+        if (key_len > static_cast<uint64_t>(limit - pointer)) {
+            throw std::runtime_error("Corrupted Meta Data");
+        }
+        key.assign(reinterpret_cast<const char *>(pointer), key_len);
+        pointer += key_len;
+    };
+
+    partitions.resize(entry_number);
+    size_t first_block = 0;
+    for (auto &partition : partitions) {
+        partition.offset = read_varint();
+        partition.size = read_varint();
+        partition.block_number = read_varint();
+        partition.first_block = first_block;
+        first_block += partition.block_number;
+        read_key(partition.fkey);
+        read_key(partition.lkey);
+    }
+    if (pointer != limit) {
+        throw std::runtime_error("Corrupted Meta Data");
+    }
+}
 }  // LOG STRUCT MERGE TREE
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /***
@@ -14,11 +15,30 @@
 | Entry Numbers(4B) | MetaEntry 1 | MetaEntry 2 | ... | MetaEntry N | Hash |
 ----------------------------------------------------------------------------
 
---------------------------------------------------------------------------------------------
-|                                        MetaEntry                                         |
---------------------------------------------------------------------------------------------
-| offset(4B) | first key len(2B) | first key(keylen) | last key len(2B) | last key(keylen) |
---------------------------------------------------------------------------------------------
+----------------------------------------------------------------------------------------------------
+|                                            MetaEntry                                             |
+----------------------------------------------------------------------------------------------------
+| offset(8B) | first key len(varint) | first key(keylen) | last key len(varint) | last key(keylen) |
+----------------------------------------------------------------------------------------------------
+Entry Numbers最高位置1表示Hash为CRC32C 否则为旧版本写入的std::hash截断值
+Entry Numbers次高位置1表示上述宽格式 否则为旧格式: offset为4字节 key len为2字节
+
+短分隔符格式: Entry Numbers第三高位置1 每个数据块只保存一个上界
+-------------------------------------------------------------------------------------------------------
+| Entry Numbers(4B) | first key len(varint) | first key | offset(8B) | separator len(varint) | ... | Hash |
+-------------------------------------------------------------------------------------------------------
+separator为不小于本块尾key且小于下一块首key的最短字符串 最后一块保存尾key本身 只有SST首key单独保存
+解码后lkey为separator 除第一项外fkey为空 此时数据块的键范围为(前一项lkey, lkey]
+
+分区索引: 数据块较多时索引拆分为若干分区 每个分区编码为一个Block 按需经块缓存读取
+Meta Section只保存常驻内存的顶层索引 格式同上 只是每一项描述一个分区
+--------------------------------------------------------------------------------------------------------
+|                                           PartitionEntry                                             |
+--------------------------------------------------------------------------------------------------------
+| offset(varint) | size(varint) | block number(varint) | first key len(varint) | first key | ... | last key |
+--------------------------------------------------------------------------------------------------------
+分区Block中每个元素对应一个数据块 key为数据块的首key 值为| offset(varint) | size(varint) | last key |
+短分隔符格式下key为数据块的separator 值中不含last key 顶层索引除第一个分区外不保存first key
 ***/
 
 namespace LSMT {
@@ -28,12 +48,41 @@ public:
 
     BlockMeta(size_t offset, const std::string &first_key, const std::string &last_key);
 
-    static void encode_meta(const std::vector<BlockMeta> &meta_entries, std::vector<uint8_t> &meta_data);
+    // shorten为true时使用短分隔符格式 meta_entries需要按键有序且相邻数据块键范围不重叠
+    static void encode_meta(const std::vector<BlockMeta> &meta_entries, std::vector<uint8_t> &meta_data,
+                            bool shorten = false);
 
     static void decode_meta(const std::vector<uint8_t> &meta_data, std::vector<BlockMeta> &meta_entries);
+
+    // 编码分区Block中数据块对应的值
+    static std::string encode_handle(size_t offset, size_t size, const std::string &last_key);
+
+    // 解析分区Block中的值 size为数据块在文件中的字节数
+    static BlockMeta decode_handle(const std::string &first_key, std::string_view handle, size_t &size);
+
+    // 返回不小于start且小于limit的最短字符串 要求start < limit 无法缩短时返回start
+    static std::string shortest_separator(const std::string &start, const std::string &limit);
 public:
+    static constexpr uint32_t CRC32C_FLAG = 0x80000000;
+    static constexpr uint32_t WIDE_FORMAT_FLAG = 0x40000000;
+    static constexpr uint32_t SEPARATOR_FLAG = 0x20000000;
+    static constexpr uint32_t FLAG_MASK = CRC32C_FLAG | WIDE_FORMAT_FLAG | SEPARATOR_FLAG;
+
     size_t offset;
+    std::string fkey;  // 数据块中键的下界 短分隔符格式中只有第一项不为空
+    std::string lkey;  // 数据块中键的上界 短分隔符格式中为separator
+};
+
+struct IndexPartition {
+    size_t offset = 0;
+    size_t size = 0;
+    size_t first_block = 0;   // 不编码 解码时按各分区的数据块数量累加
+    size_t block_number = 0;
     std::string fkey;
     std::string lkey;
+
+    static void encode_partitions(const std::vector<IndexPartition> &partitions, std::vector<uint8_t> &meta_data);
+
+    static void decode_partitions(const std::vector<uint8_t> &meta_data, std::vector<IndexPartition> &partitions);
 };
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "clock_cache.h"
+
+namespace LSMT {
+ClockCache::ClockCache(size_t capacity, CacheAdmission admission)
+: capacity(capacity), used(0), hand(0), slots(capacity), hit_requests(0), sum_requests(0) {
+    if (admission == CacheAdmission::TINYLFU) {
+        sketch = std::make_unique<CountMinSketch>(capacity);
+    }
+}
+
+ClockCache::~ClockCache() = default;
+
+std::shared_ptr<Block> ClockCache::get(int sst_id, int block_id, CachePriority priority) {
+    // 读路径只持有共享锁 命中时通过原子操作设置引用位 不修改任何链表结构
+    std::shared_lock<std::shared_mutex> lock(cache_mutex);
+
+    if (sketch != nullptr && priority == CachePriority::NORMAL) {
+        sketch->increment(BlockCache::hash_key(sst_id, block_id));
+    }
+
+    sum_requests.fetch_add(1, std::memory_order_relaxed);
+    auto it = hashmap.find(std::make_pair(sst_id, block_id));
+    if (it == hashmap.end()) {
+        return nullptr;
+    }
+    hit_requests.fetch_add(1, std::memory_order_relaxed);
+
+    ClockSlot &slot = slots[it->second];
+    if (priority == CachePriority::NORMAL && !slot.referenced.load(std::memory_order_relaxed)) {
+        slot.referenced.store(true, std::memory_order_relaxed);
+    }
+    return slot.block;
+}
+
+void ClockCache::put(int sst_id, int block_id, std::shared_ptr<Block> block, CachePriority priority) {
+    if (priority == CachePriority::BYPASS || capacity == 0) {
+        return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(cache_mutex);
+
+    auto key = std::make_pair(sst_id, block_id);
+    if (hashmap.find(key) != hashmap.end()) { return; }
+
+    size_t index;
+    if (!free_slots.empty()) {
+        index = free_slots.back();
+        free_slots.pop_back();
+    } else if (used < capacity) {
+        index = used++;
+    } else {
+        index = find_victim();
+        ClockSlot &victim = slots[index];
+        if (sketch != nullptr && priority != CachePriority::WARM && sketch->estimate(BlockCache::hash_key(sst_id, block_id)) <=
+                sketch->estimate(BlockCache::hash_key(victim.sst_id, victim.blk_id))) {
+            return;
+        }
+        release_slot(index);
+    }
+
+    // LOW优先级插入时不设置引用位 下一轮扫描即可被淘汰
+    ClockSlot &slot = slots[index];
+    slot.sst_id = sst_id;
+    slot.blk_id = block_id;
+    slot.block = block;
+    slot.referenced.store(priority != CachePriority::LOW, std::memory_order_relaxed);
+    hashmap[key] = index;
+    sst_slots[sst_id].insert(index);
+}
+
+void ClockCache::erase_sst(int sst_id) {
+    std::unique_lock<std::shared_mutex> lock(cache_mutex);
+
+    auto sst_it = sst_slots.find(sst_id);
+    if (sst_it == sst_slots.end()) {
+        return;
+    }
+    for (size_t index : sst_it->second) {
+        ClockSlot &slot = slots[index];
+        hashmap.erase(std::make_pair(slot.sst_id, slot.blk_id));
+        slot.sst_id = -1;
+        slot.blk_id = -1;
+        slot.block = nullptr;
+        slot.referenced.store(false, std::memory_order_relaxed);
+        free_slots.push_back(index);
+    }
+    sst_slots.erase(sst_it);
+}
+
+std::vector<int> ClockCache::cached_blocks(int sst_id) const {
+    std::shared_lock<std::shared_mutex> lock(cache_mutex);
+
+    std::vector<int> block_ids;
+    auto sst_it = sst_slots.find(sst_id);
+    if (sst_it != sst_slots.end()) {
+        for (size_t index : sst_it->second) {
+            block_ids.push_back(slots[index].blk_id);
+        }
+    }
+    return block_ids;
+}
+
+double ClockCache::hit_rate() const {
+    size_t sum = sum_requests.load(std::memory_order_relaxed);
+    size_t hit = hit_requests.load(std::memory_order_relaxed);
+    return sum == 0 ? 0.0 : static_cast<double>(hit) / sum;
+}
+
+size_t ClockCache::get_capacity() const {
+    return capacity;
+}
+
+size_t ClockCache::get_usage() const {
+    std::shared_lock<std::shared_mutex> lock(cache_mutex);
+    return hashmap.size();
+}
+
+size_t ClockCache::find_victim() {
+    while (true) {
+        ClockSlot &slot = slots[hand];
+        size_t index = hand;
+        hand = (hand + 1) % capacity;
+        if (!slot.referenced.exchange(false, std::memory_order_relaxed)) {
+            return index;
+        }
+    }
+}
+
+void ClockCache::release_slot(size_t index) {
+    ClockSlot &slot = slots[index];
+    hashmap.erase(std::make_pair(slot.sst_id, slot.blk_id));
+
+    auto sst_it = sst_slots.find(slot.sst_id);
+    sst_it->second.erase(index);
+    if (sst_it->second.empty()) {
+        sst_slots.erase(sst_it);
+    }
+}
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "block.h"
+#include "block_cache.h"
+#include "utils/count_min_sketch.h"
+
+/***
+----------------------------------------------------------------
+|                     CLOCK Ring Buffer                        |
+----------------------------------------------------------------
+| Slot 0 | Slot 1 | ... | Slot hand | ... | Slot capacity - 1  |
+----------------------------------------------------------------
+命中只原子地设置引用位 淘汰时指针环形扫描 清除引用位直到遇到未被引用的槽位
+***/
+
+namespace LSMT {
+struct ClockSlot {
+    int sst_id = -1;
+    int blk_id = -1;
+    std::atomic<bool> referenced{false};
+    std::shared_ptr<Block> block;
+};
+
+class ClockCache : public BaseCache {
+public:
+    ClockCache(size_t capacity, CacheAdmission admission = CacheAdmission::NONE);
+
+    ~ClockCache();
+
+    std::shared_ptr<Block> get(int sst_id, int block_id, CachePriority priority = CachePriority::NORMAL) override;
+
+    void put(int sst_id, int block_id, std::shared_ptr<Block> block,
+        CachePriority priority = CachePriority::NORMAL) override;
+
+    void erase_sst(int sst_id) override;
+
+    std::vector<int> cached_blocks(int sst_id) const override;
+
+    double hit_rate() const override;
+
+    size_t get_capacity() const override;
+
+    size_t get_usage() const override;
+
+private:
+    size_t find_victim();
+
+    void release_slot(size_t index);
+
+private:
+    size_t capacity;
+    size_t used;
+    size_t hand;
+    mutable std::shared_mutex cache_mutex;
+    std::vector<ClockSlot> slots;
+    std::unordered_map<std::pair<int, int>, size_t, PairHash, PairEqual> hashmap;
+    std::unordered_map<int, std::unordered_set<size_t>> sst_slots;  // 每个SST已缓存数据块所在的槽位
+    std::vector<size_t> free_slots;
+    std::unique_ptr<CountMinSketch> sketch;
+    std::atomic<size_t> hit_requests;
+    std::atomic<size_t> sum_requests;
+};
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "learned_index.h"
+#include "utils/coding.h"
+#include "utils/crc32c.h"
+
+namespace LSMT {
+std::shared_ptr<LearnedIndex> LearnedIndex::build(const std::vector<BlockMeta> &meta_entries, size_t error) {
+    if (meta_entries.empty() || error == 0) {
+        return nullptr;
+    }
+    auto index = std::make_shared<LearnedIndex>();
+    const std::string &first = meta_entries.front().lkey;
+    const std::string &last = meta_entries.back().lkey;
+    size_t prefix_length = 0;
+    while (prefix_length < std::min(first.size(), last.size()) && first[prefix_length] == last[prefix_length]) {
+        ++prefix_length;
+    }
+    index->prefix = first.substr(0, prefix_length);
+    index->block_number = meta_entries.size();
+
+    std::vector<uint64_t> points(meta_entries.size());
+    for (size_t i = 0; i < meta_entries.size(); ++i) {
+        points[i] = index->to_number(meta_entries[i].lkey);
+    }
+
+    // 收缩锥: 以段内第一个点为原点 维护使所有点误差不超过error的斜率区间 区间为空时开始新的一段
+    size_t origin = 0;
+    double slope_lo = 0;
+    double slope_hi = std::numeric_limits<double>::infinity();
+    auto finish_segment = [&]() {
+        double slope = std::isinf(slope_hi) ? slope_lo : (slope_lo + slope_hi) / 2;
+        index->segments.push_back(Segment{points[origin], origin, slope});
+    };
+    for (size_t i = 1; i < points.size(); ++i) {
+        double dy = static_cast<double>(i - origin);
+        if (points[i] == points[origin]) {
+            if (dy > error) {
+                finish_segment();
+                origin = i;
+                slope_lo = 0;
+                slope_hi = std::numeric_limits<double>::infinity();
+            }
+            continue;
+        }
+        double dx = static_cast<double>(points[i] - points[origin]);
+        double lo = std::max(slope_lo, (dy - error) / dx);
+        double hi = std::min(slope_hi, (dy + error) / dx);
+        if (lo > hi) {
+            finish_segment();
+            origin = i;
+            slope_lo = 0;
+            slope_hi = std::numeric_limits<double>::infinity();
+        } else {
+            slope_lo = lo;
+            slope_hi = hi;
+        }
+    }
+    finish_segment();
+
+    // 浮点舍入和重复映射值可能使误差略超目标 按实际预测记录最大误差
+    for (size_t i = 0; i < points.size(); ++i) {
+        size_t predicted = index->predict_block(index->find_segment(points[i]), points[i]);
+        index->max_error = std::max(index->max_error, predicted > i ? predicted - i : i - predicted);
+    }
+    if (index->segments.size() * 4 > meta_entries.size() || index->max_error > 2 * error) {
+        return nullptr;
+    }
+    return index;
+}
+
+std::pair<size_t, size_t> LearnedIndex::predict(const std::string &key) const {
+    uint64_t x = to_number(key);
+    size_t predicted = predict_block(find_segment(x), x);
+    size_t first = predicted > max_error ? predicted - max_error : 0;
+    size_t second = std::min(predicted + max_error + 2, block_number);
+    return std::make_pair(first, second);
+}
+
+uint64_t LearnedIndex::to_number(const std::string &key) const {
+    // 不以公共前缀开头的key整体小于或大于所有样本点
+    if (key.compare(0, prefix.size(), prefix) != 0) {
+        return key < prefix ? 0 : UINT64_MAX;
+    }
+    uint64_t number = 0;
+    for (size_t i = prefix.size(); i < prefix.size() + sizeof(uint64_t); ++i) {
+        number = (number << 8) | (i < key.size() ? static_cast<uint8_t>(key[i]) : 0);
+    }
+    return number;
+}
+
+size_t LearnedIndex::predict_block(size_t segment_id, uint64_t x) const {
+    const Segment &segment = segments[segment_id];
+    double lower = static_cast<double>(segment.first_block);
+    double upper = static_cast<double>(segment_id + 1 < segments.size()
+        ? segments[segment_id + 1].first_block : block_number - 1);
+    if (x <= segment.key) {
+        return segment.first_block;
+    }
+    double predicted = lower + segment.slope * static_cast<double>(x - segment.key);
+    return static_cast<size_t>(std::clamp(std::round(predicted), lower, upper));
+}
+
+size_t LearnedIndex::find_segment(uint64_t x) const {
+    auto it = std::upper_bound(segments.begin(), segments.end(), x,
+        [](uint64_t x, const Segment &segment) { return x < segment.key; });
+    return it == segments.begin() ? 0 : it - segments.begin() - 1;
+}
+
+size_t LearnedIndex::get_segment_number() const {
+    return segments.size();
+}
+
+size_t LearnedIndex::get_max_error() const {
+    return max_error;
+}
+
+size_t LearnedIndex::get_block_number() const {
+    return block_number;
+}
+
+std::vector<uint8_t> LearnedIndex::encode() const {
+    std::vector<uint8_t> encoded;
+    put_varint(encoded, prefix.size());
+    encoded.insert(encoded.end(), prefix.begin(), prefix.end());
+    put_varint(encoded, block_number);
+    put_varint(encoded, max_error);
+    put_varint(encoded, segments.size());
+    for (const auto &segment : segments) {
+        size_t size = encoded.size();
+        encoded.resize(size + sizeof(uint64_t));
+        memcpy(encoded.data() + size, &segment.key, sizeof(uint64_t));
+        put_varint(encoded, segment.first_block);
+        size = encoded.size();
+        encoded.resize(size + sizeof(double));
+        memcpy(encoded.data() + size, &segment.slope, sizeof(double));
+    }
+
+    uint32_t hash_value = crc32c(encoded.data(), encoded.size());
+    encoded.resize(encoded.size() + sizeof(uint32_t));
+    memcpy(encoded.data() + encoded.size() - sizeof(uint32_t), &hash_value, sizeof(uint32_t));
+    return encoded;
+}
+
+std::shared_ptr<LearnedIndex> LearnedIndex::decode(const uint8_t *data, size_t size) {
+    if (size < sizeof(uint32_t)) {
+        throw std::runtime_error("Corrupted Learned Index");
+    }
+    size_t payload_size = size - sizeof(uint32_t);
+    uint32_t hash_value;
+    memcpy(&hash_value, data + payload_size, sizeof(uint32_t));
+    if (hash_value != crc32c(data, payload_size)) {
+        throw std::runtime_error("Learned Index Hash Verification Error");
+    }
+
+    const uint8_t *pointer = data;
+    const uint8_t *limit = data + payload_size;
+    auto read_varint = [&pointer, limit]() {
+        uint64_t value;
+        pointer = decode_varint(pointer, limit, value);
+        if (pointer == nullptr) {
+            throw std::runtime_error("Corrupted Learned Index");
+        }
+        return value;
+    };
+    auto read_fixed = [&pointer, limit](void *value, size_t length) {
+        if (static_cast<size_t>(limit - pointer) < length) {
+            throw std::runtime_error("Corrupted Learned Index");
+        }
+        memcpy(value, pointer, length);
+        pointer += length;
+    };
+
+    auto index = std::make_shared<LearnedIndex>();
+    uint64_t prefix_length = read_varint();
+    if (prefix_length > static_cast<uint64_t>(limit - pointer)) {
+        throw std::runtime_error("Corrupted Learned Index");
+    }
+    index->prefix.assign(reinterpret_cast<const char *>(pointer), prefix_length);
+    pointer += prefix_length;
+    index->block_number = read_varint();
+    index->max_error = read_varint();
+    // 每段至少17字节 避免损坏的数量导致过量分配
+    uint64_t segment_number = read_varint();
+    if (segment_number == 0 || segment_number > static_cast<uint64_t>(limit - pointer) / 17) {
+        throw std::runtime_error("Corrupted Learned Index");
+    }
+    index->segments.resize(segment_number);
+    for (size_t i = 0; i < segment_number; ++i) {
+        Segment &segment = index->segments[i];
+        read_fixed(&segment.key, sizeof(uint64_t));
+        segment.first_block = read_varint();
+        read_fixed(&segment.slope, sizeof(double));
+        if (segment.first_block >= index->block_number || !std::isfinite(segment.slope) || segment.slope < 0 ||
+            (i > 0 && (segment.key < index->segments[i - 1].key ||
+                       segment.first_block <= index->segments[i - 1].first_block))) {
+            throw std::runtime_error("Corrupted Learned Index");
+        }
+    }
+    if (pointer != limit) {
+        throw std::runtime_error("Corrupted Learned Index");
+    }
+    return index;
+}
+} // LOG STRUCTURED MERGE TREE
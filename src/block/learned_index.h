@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "block_meta.h"
+
+/***
+------------------------------------------------------------------------------------------------------------
+|                                              Learned Index                                               |
+------------------------------------------------------------------------------------------------------------
+| Prefix Len(varint) | Prefix | Block Number(varint) | Max Error(varint) | Segment Number(varint) | ...    |
+------------------------------------------------------------------------------------------------------------
+| Segment 1 | ... | Segment N | CRC32C(4B) |
+------------------------------------------
+Segment: | Key(8B) | First Block(varint) | Slope(8B double) |
+参考PGM-index: 去掉所有数据块上界的公共前缀后 取之后8字节按大端序映射为整数 键序下单调不减
+以各数据块上界为样本点做分段线性拟合 每段从第一个样本点出发 预测值与真实数据块编号之差不超过Max Error
+查找时只在预测位置附近的窗口内二分 窗口无法确定结果时回退到全量二分 因此模型只影响速度不影响正确性
+***/
+
+namespace LSMT {
+class LearnedIndex {
+public:
+    // 对meta_entries的上界(lkey)做拟合 error为目标误差 分段过多或误差超出时返回nullptr 不值得使用
+    static std::shared_ptr<LearnedIndex> build(const std::vector<BlockMeta> &meta_entries, size_t error);
+
+    // 返回第一个上界不小于key的数据块所在的窗口[first, second) 结果不在窗口内时由调用方回退
+    std::pair<size_t, size_t> predict(const std::string &key) const;
+
+    std::vector<uint8_t> encode() const;
+
+    // 校验失败或数据不完整时抛出异常
+    static std::shared_ptr<LearnedIndex> decode(const uint8_t *data, size_t size);
+
+    size_t get_segment_number() const;
+
+    size_t get_max_error() const;
+
+    size_t get_block_number() const;
+
+private:
+    struct Segment {
+        uint64_t key;        // 第一个样本点的映射值
+        size_t first_block;  // 第一个样本点的数据块编号
+        double slope;
+    };
+
+    uint64_t to_number(const std::string &key) const;
+
+    // 第segment_id段在x处的预测值 限制在本段和下一段的起始编号之间
+    size_t predict_block(size_t segment_id, uint64_t x) const;
+
+    size_t find_segment(uint64_t x) const;
+
+private:
+    std::string prefix;  // 所有上界的公共前缀
+    size_t block_number = 0;
+    size_t max_error = 0;
+    std::vector<Segment> segments;
+};
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,88 @@
+#include "meta_cache.h"
+
+namespace LSMT {
+MetaCache::MetaCache(size_t capacity)
+: capacity(capacity), usage(0), pinned_usage(0), hit_requests(0), sum_requests(0) { }
+
+MetaCache::~MetaCache() = default;
+
+std::shared_ptr<SSTMeta> MetaCache::get(int sst_id) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    sum_requests++;
+    auto pinned_it = pinned.find(sst_id);
+    if (pinned_it != pinned.end()) {
+        hit_requests++;
+        return pinned_it->second;
+    }
+    auto it = hashmap.find(sst_id);
+    if (it == hashmap.end()) {
+        return nullptr;
+    }
+    hit_requests++;
+    lru_list.splice(lru_list.begin(), lru_list, it->second);
+    return it->second->meta;
+}
+
+void MetaCache::put(int sst_id, std::shared_ptr<SSTMeta> meta, bool pinned) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    if (this->pinned.find(sst_id) != this->pinned.end() || hashmap.find(sst_id) != hashmap.end()) {
+        return;
+    }
+
+    // 固定的索引和过滤器只计入用量 不参与淘汰
+    usage += meta->charge;
+    if (pinned) {
+        pinned_usage += meta->charge;
+        this->pinned[sst_id] = meta;
+    } else {
+        lru_list.push_front(MetaItem{sst_id, meta});
+        hashmap[sst_id] = lru_list.begin();
+    }
+    evict();
+}
+
+void MetaCache::erase(int sst_id) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    auto pinned_it = pinned.find(sst_id);
+    if (pinned_it != pinned.end()) {
+        usage -= pinned_it->second->charge;
+        pinned_usage -= pinned_it->second->charge;
+        pinned.erase(pinned_it);
+        return;
+    }
+    auto it = hashmap.find(sst_id);
+    if (it != hashmap.end()) {
+        usage -= it->second->meta->charge;
+        lru_list.erase(it->second);
+        hashmap.erase(it);
+    }
+}
+
+size_t MetaCache::get_usage() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return usage;
+}
+
+size_t MetaCache::get_pinned_usage() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return pinned_usage;
+}
+
+double MetaCache::hit_rate() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return sum_requests == 0 ? 0.0 : static_cast<double>(hit_requests) / sum_requests;
+}
+
+void MetaCache::evict() {
+    // 保留最近插入的条目 即使其本身超过容量 调用方仍持有它直到本次访问结束
+    while (usage > capacity && lru_list.size() > 1) {
+        auto &item = lru_list.back();
+        usage -= item.meta->charge;
+        hashmap.erase(item.sst_id);
+        lru_list.pop_back();
+    }
+}
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "block_meta.h"
+#include "learned_index.h"
+#include "utils/filter.h"
+
+/***
+----------------------------------------------------------------
+|                     High Priority Pool                       |
+----------------------------------------------------------------
+|   Pinned SST Meta (不参与淘汰)   |   LRU SST Meta (按字节淘汰)   |
+----------------------------------------------------------------
+缓存每个SST的索引(Meta Section)和过滤器 容量从块缓存中预留 与数据块互不挤占
+***/
+
+namespace LSMT {
+struct SSTMeta {
+    std::vector<BlockMeta> meta_entries;
+    std::vector<IndexPartition> partitions;  // 分区索引的顶层索引 此时meta_entries为空
+    std::shared_ptr<LearnedIndex> learned_index;  // 可选 只用于扁平索引
+    FilterSection filters;
+    size_t charge;  // 索引和过滤器在文件中的字节数
+};
+
+class MetaCache {
+public:
+    MetaCache(size_t capacity);
+
+    ~MetaCache();
+
+    std::shared_ptr<SSTMeta> get(int sst_id);
+
+    void put(int sst_id, std::shared_ptr<SSTMeta> meta, bool pinned = false);
+
+    void erase(int sst_id);
+
+    size_t get_usage() const;
+
+    size_t get_pinned_usage() const;
+
+    double hit_rate() const;
+
+private:
+    struct MetaItem {
+        int sst_id;
+        std::shared_ptr<SSTMeta> meta;
+    };
+
+    void evict();
+
+private:
+    size_t capacity;
+    size_t usage;
+    size_t pinned_usage;
+    mutable std::mutex cache_mutex;
+    std::list<MetaItem> lru_list;
+    std::unordered_map<int, std::list<MetaItem>::iterator> hashmap;
+    std::unordered_map<int, std::shared_ptr<SSTMeta>> pinned;
+    size_t hit_requests;
+    size_t sum_requests;
+};
+} // LOG STRUCTURED MERGE TREE
@@ -29,12 +29,37 @@ bool TomlConfig::load_config_file() {
         lsm_per_memtable_size = lsmt_config.at_path("LSM_PER_MEMTABLE_SIZE").value<uint64_t>().value();
         lsm_sst_level_ratio   = lsmt_config.at_path("LSM_SST_LEVEL_RATIO").value<int>().value();
         lsm_block_size        = lsmt_config.at_path("LSM_BLOCK_SIZE").value<int>().value();
+        lsm_block_restart_interval = lsmt_config.at_path("LSM_BLOCK_RESTART_INTERVAL").value<int>().value();
+        lsm_block_trx_id_delta     = lsmt_config.at_path("LSM_BLOCK_TRX_ID_DELTA").value<bool>().value();
+        lsm_index_partition_size   = lsmt_config.at_path("LSM_INDEX_PARTITION_SIZE").value<int>().value();
+        lsm_index_short_separator  = lsmt_config.at_path("LSM_INDEX_SHORT_SEPARATOR").value<bool>().value();
+        lsm_index_learned_error    = lsmt_config.at_path("LSM_INDEX_LEARNED_ERROR").value<int>().value();
         lsm_block_cache_size  = lsmt_config.at_path("LSM_BLOCK_CACHE_SIZE").value<int>().value();
         lsm_block_cache_lruk  = lsmt_config.at_path("LSM_BLOCK_CACHE_LRUK").value<int>().value();
+        lsm_block_cache_policy        = lsmt_config.at_path("LSM_BLOCK_CACHE_POLICY").value<std::string>().value();
+        lsm_block_cache_admission     = lsmt_config.at_path("LSM_BLOCK_CACHE_ADMISSION").value<std::string>().value();
+        lsm_scan_cache_priority       = lsmt_config.at_path("LSM_SCAN_CACHE_PRIORITY").value<std::string>().value();
+        lsm_compaction_cache_priority = lsmt_config.at_path("LSM_COMPACTION_CACHE_PRIORITY").value<std::string>().value();
+        lsm_block_cache_prepopulate   = lsmt_config.at_path("LSM_BLOCK_CACHE_PREPOPULATE").value<std::string>().value();
+        lsm_cache_index_and_filter      = lsmt_config.at_path("LSM_CACHE_INDEX_AND_FILTER").value<bool>().value();
+        lsm_high_priority_pool_ratio    = lsmt_config.at_path("LSM_HIGH_PRIORITY_POOL_RATIO").value<double>().value();
+        lsm_pin_index_and_filter_levels = lsmt_config.at_path("LSM_PIN_INDEX_AND_FILTER_LEVELS").value<int>().value();
+        lsm_block_hash_index_levels     = lsmt_config.at_path("LSM_BLOCK_HASH_INDEX_LEVELS").value<int>().value();
+        lsm_block_compression           = lsmt_config.at_path("LSM_BLOCK_COMPRESSION").value<std::string>().value();
+        lsm_block_compression_ratio     = lsmt_config.at_path("LSM_BLOCK_COMPRESSION_RATIO").value<double>().value();
+        lsm_block_verify_checksum       = lsmt_config.at_path("LSM_BLOCK_VERIFY_CHECKSUM").value<bool>().value();
+        lsm_blob_min_size               = lsmt_config.at_path("LSM_BLOB_MIN_SIZE").value<int>().value();
+        lsm_blob_gc_ratio               = lsmt_config.at_path("LSM_BLOB_GC_RATIO").value<double>().value();
 
         auto bf_config = config["bloom_filter"];
         bloom_filter_expected_elements = bf_config.at_path("BLOOM_FILTER_EXPECTED_ELEMENTS").value<int>().value();
         bloom_filter_false_positive_rate = bf_config.at_path("BLOOM_FILTER_FALSE_POSITIVE_RATE").value<double>().value();
+        bloom_filter_bits_per_key = bf_config.at_path("BLOOM_FILTER_BITS_PER_KEY").value<double>().value();
+        bloom_filter_allocation = bf_config.at_path("BLOOM_FILTER_ALLOCATION").value<std::string>().value();
+        bloom_filter_deep_level_type = bf_config.at_path("BLOOM_FILTER_DEEP_LEVEL_TYPE").value<std::string>().value();
+        bloom_filter_deep_level = bf_config.at_path("BLOOM_FILTER_DEEP_LEVEL").value<int>().value();
+        bloom_filter_prefix_extractor = bf_config.at_path("BLOOM_FILTER_PREFIX_EXTRACTOR").value<std::string>().value();
+        bloom_filter_range_filter = bf_config.at_path("BLOOM_FILTER_RANGE_FILTER").value<bool>().value();
 
         return true;
     } catch (const std::exception &err) {
@@ -51,8 +76,27 @@ bool TomlConfig::save_config_file() {
                 {"LSM_PER_MEMTABLE_SIZE", lsm_per_memtable_size},
                 {"LSM_SST_LEVEL_RATIO",   lsm_sst_level_ratio},
                 {"LSM_BLOCK_SIZE",        lsm_block_size},
+                {"LSM_BLOCK_RESTART_INTERVAL", lsm_block_restart_interval},
+                {"LSM_BLOCK_TRX_ID_DELTA",     lsm_block_trx_id_delta},
+                {"LSM_INDEX_PARTITION_SIZE",   lsm_index_partition_size},
+                {"LSM_INDEX_SHORT_SEPARATOR",  lsm_index_short_separator},
+                {"LSM_INDEX_LEARNED_ERROR",    lsm_index_learned_error},
                 {"LSM_BLOCK_CACHE_SIZE",  lsm_block_cache_size},
                 {"LSM_BLOCK_CACHE_LRUK",  lsm_block_cache_lruk},
+                {"LSM_BLOCK_CACHE_POLICY",        lsm_block_cache_policy},
+                {"LSM_BLOCK_CACHE_ADMISSION",     lsm_block_cache_admission},
+                {"LSM_SCAN_CACHE_PRIORITY",       lsm_scan_cache_priority},
+                {"LSM_COMPACTION_CACHE_PRIORITY", lsm_compaction_cache_priority},
+                {"LSM_BLOCK_CACHE_PREPOPULATE",   lsm_block_cache_prepopulate},
+                {"LSM_CACHE_INDEX_AND_FILTER",      lsm_cache_index_and_filter},
+                {"LSM_HIGH_PRIORITY_POOL_RATIO",    lsm_high_priority_pool_ratio},
+                {"LSM_PIN_INDEX_AND_FILTER_LEVELS", lsm_pin_index_and_filter_levels},
+                {"LSM_BLOCK_HASH_INDEX_LEVELS",     lsm_block_hash_index_levels},
+                {"LSM_BLOCK_COMPRESSION",           lsm_block_compression},
+                {"LSM_BLOCK_COMPRESSION_RATIO",     lsm_block_compression_ratio},
+                {"LSM_BLOCK_VERIFY_CHECKSUM",       lsm_block_verify_checksum},
+                {"LSM_BLOB_MIN_SIZE",               lsm_blob_min_size},
+                {"LSM_BLOB_GC_RATIO",               lsm_blob_gc_ratio},
             }},
             {"redis", toml::table{
 
@@ -60,6 +104,12 @@ bool TomlConfig::save_config_file() {
             {"bloom_filter", toml::table{
                 {"BLOOM_FILTER_EXPECTED_ELEMENTS", bloom_filter_expected_elements},
                 {"BLOOM_FILTER_FALSE_POSITIVE_RATE", bloom_filter_false_positive_rate},
+                {"BLOOM_FILTER_BITS_PER_KEY", bloom_filter_bits_per_key},
+                {"BLOOM_FILTER_ALLOCATION", bloom_filter_allocation},
+                {"BLOOM_FILTER_DEEP_LEVEL_TYPE", bloom_filter_deep_level_type},
+                {"BLOOM_FILTER_DEEP_LEVEL", bloom_filter_deep_level},
+                {"BLOOM_FILTER_PREFIX_EXTRACTOR", bloom_filter_prefix_extractor},
+                {"BLOOM_FILTER_RANGE_FILTER", bloom_filter_range_filter},
             }},
         };
 
@@ -78,11 +128,36 @@ void TomlConfig::set_default_value() {
     lsm_per_memtable_size = 1024 * 1024 * 4;
     lsm_sst_level_ratio   = 4;
     lsm_block_size        = 1024 * 32;
+    lsm_block_restart_interval = 16;
+    lsm_block_trx_id_delta     = true;
+    lsm_index_partition_size   = 16384;
+    lsm_index_short_separator  = true;
+    lsm_index_learned_error    = 0;
     lsm_block_cache_size  = 1024;
     lsm_block_cache_lruk  = 8;
+    lsm_block_cache_policy        = "lruk";
+    lsm_block_cache_admission     = "none";
+    lsm_scan_cache_priority       = "low";
+    lsm_compaction_cache_priority = "bypass";
+    lsm_block_cache_prepopulate   = "none";
+    lsm_cache_index_and_filter      = false;
+    lsm_high_priority_pool_ratio    = 0.1;
+    lsm_pin_index_and_filter_levels = 1;
+    lsm_block_hash_index_levels     = 0;
+    lsm_block_compression           = "none,lz4";
+    lsm_block_compression_ratio     = 0.875;
+    lsm_block_verify_checksum       = true;
+    lsm_blob_min_size               = 0;
+    lsm_blob_gc_ratio               = 0.5;
 
     bloom_filter_expected_elements = 65536;
     bloom_filter_false_positive_rate = 0.1;
+    bloom_filter_bits_per_key = 10.0;
+    bloom_filter_allocation = "monkey";
+    bloom_filter_deep_level_type = "fuse";
+    bloom_filter_deep_level = 2;
+    bloom_filter_prefix_extractor = "none";
+    bloom_filter_range_filter = false;
 }
 
 const TomlConfig &TomlConfig::get_instance(const std::string &file_path) {
@@ -114,6 +189,26 @@ int TomlConfig::get_lsm_block_size() const {
     return lsm_block_size;
 }
 
+int TomlConfig::get_lsm_block_restart_interval() const {
+    return lsm_block_restart_interval;
+}
+
+bool TomlConfig::get_lsm_block_trx_id_delta() const {
+    return lsm_block_trx_id_delta;
+}
+
+int TomlConfig::get_lsm_index_partition_size() const {
+    return lsm_index_partition_size;
+}
+
+bool TomlConfig::get_lsm_index_short_separator() const {
+    return lsm_index_short_separator;
+}
+
+int TomlConfig::get_lsm_index_learned_error() const {
+    return lsm_index_learned_error;
+}
+
 int TomlConfig::get_lsm_block_cache_size() const {
     return lsm_block_cache_size;
 }
@@ -122,6 +217,62 @@ int TomlConfig::get_lsm_block_cache_lruk() const {
     return lsm_block_cache_lruk;
 }
 
+std::string TomlConfig::get_lsm_block_cache_policy() const {
+    return lsm_block_cache_policy;
+}
+
+std::string TomlConfig::get_lsm_block_cache_admission() const {
+    return lsm_block_cache_admission;
+}
+
+std::string TomlConfig::get_lsm_scan_cache_priority() const {
+    return lsm_scan_cache_priority;
+}
+
+std::string TomlConfig::get_lsm_compaction_cache_priority() const {
+    return lsm_compaction_cache_priority;
+}
+
+std::string TomlConfig::get_lsm_block_cache_prepopulate() const {
+    return lsm_block_cache_prepopulate;
+}
+
+bool TomlConfig::get_lsm_cache_index_and_filter() const {
+    return lsm_cache_index_and_filter;
+}
+
+double TomlConfig::get_lsm_high_priority_pool_ratio() const {
+    return lsm_high_priority_pool_ratio;
+}
+
+int TomlConfig::get_lsm_pin_index_and_filter_levels() const {
+    return lsm_pin_index_and_filter_levels;
+}
+
+int TomlConfig::get_lsm_block_hash_index_levels() const {
+    return lsm_block_hash_index_levels;
+}
+
+std::string TomlConfig::get_lsm_block_compression() const {
+    return lsm_block_compression;
+}
+
+double TomlConfig::get_lsm_block_compression_ratio() const {
+    return lsm_block_compression_ratio;
+}
+
+bool TomlConfig::get_lsm_block_verify_checksum() const {
+    return lsm_block_verify_checksum;
+}
+
+int TomlConfig::get_lsm_blob_min_size() const {
+    return lsm_blob_min_size;
+}
+
+double TomlConfig::get_lsm_blob_gc_ratio() const {
+    return lsm_blob_gc_ratio;
+}
+
 int TomlConfig::get_bloom_filter_expected_elements() const {
     return bloom_filter_expected_elements;
 }
@@ -129,4 +280,28 @@ int TomlConfig::get_bloom_filter_expected_elements() const {
 double TomlConfig::get_bloom_filter_false_positive_rate() const {
     return bloom_filter_false_positive_rate;
 }
+
+double TomlConfig::get_bloom_filter_bits_per_key() const {
+    return bloom_filter_bits_per_key;
+}
+
+std::string TomlConfig::get_bloom_filter_allocation() const {
+    return bloom_filter_allocation;
+}
+
+std::string TomlConfig::get_bloom_filter_deep_level_type() const {
+    return bloom_filter_deep_level_type;
+}
+
+int TomlConfig::get_bloom_filter_deep_level() const {
+    return bloom_filter_deep_level;
+}
+
+std::string TomlConfig::get_bloom_filter_prefix_extractor() const {
+    return bloom_filter_prefix_extractor;
+}
+
+bool TomlConfig::get_bloom_filter_range_filter() const {
+    return bloom_filter_range_filter;
+}
 } // LOG STRUCTURED MERGE TREE
@@ -16,14 +16,64 @@ public:
 
     int get_lsm_block_size() const;
 
+    int get_lsm_block_restart_interval() const;
+
+    bool get_lsm_block_trx_id_delta() const;
+
+    int get_lsm_index_partition_size() const;
+
+    bool get_lsm_index_short_separator() const;
+
+    int get_lsm_index_learned_error() const;
+
     int get_lsm_block_cache_size() const;
 
     int get_lsm_block_cache_lruk() const;
 
+    std::string get_lsm_block_cache_policy() const;
+
+    std::string get_lsm_block_cache_admission() const;
+
+    std::string get_lsm_scan_cache_priority() const;
+
+    std::string get_lsm_compaction_cache_priority() const;
+
+    std::string get_lsm_block_cache_prepopulate() const;
+
+    bool get_lsm_cache_index_and_filter() const;
+
+    double get_lsm_high_priority_pool_ratio() const;
+
+    int get_lsm_pin_index_and_filter_levels() const;
+
+    int get_lsm_block_hash_index_levels() const;
+
+    std::string get_lsm_block_compression() const;
+
+    double get_lsm_block_compression_ratio() const;
+
+    bool get_lsm_block_verify_checksum() const;
+
+    int get_lsm_blob_min_size() const;
+
+    double get_lsm_blob_gc_ratio() const;
+
     int get_bloom_filter_expected_elements() const;
 
     double get_bloom_filter_false_positive_rate() const;
 
+    double get_bloom_filter_bits_per_key() const;
+
+    std::string get_bloom_filter_allocation() const;
+
+    std::string get_bloom_filter_deep_level_type() const;
+
+    int get_bloom_filter_deep_level() const;
+
+    std::string get_bloom_filter_prefix_extractor() const;
+
+    bool get_bloom_filter_range_filter() const;
+
     static const TomlConfig &get_instance(const std::string &file_path = "config.toml");
 
 private:
@@ -42,10 +92,35 @@ private:
     long long lsm_per_memtable_size;
     int lsm_sst_level_ratio;
     int lsm_block_size;
+    int lsm_block_restart_interval;
+    bool lsm_block_trx_id_delta;
+    int lsm_index_partition_size;
+    bool lsm_index_short_separator;
+    int lsm_index_learned_error;
     int lsm_block_cache_size;
     int lsm_block_cache_lruk;
+    std::string lsm_block_cache_policy;
+    std::string lsm_block_cache_admission;
+    std::string lsm_scan_cache_priority;
+    std::string lsm_compaction_cache_priority;
+    std::string lsm_block_cache_prepopulate;
+    bool lsm_cache_index_and_filter;
+    double lsm_high_priority_pool_ratio;
+    int lsm_pin_index_and_filter_levels;
+    int lsm_block_hash_index_levels;
+    std::string lsm_block_compression;
+    double lsm_block_compression_ratio;
+    bool lsm_block_verify_checksum;
+    int lsm_blob_min_size;
+    double lsm_blob_gc_ratio;
 
     int bloom_filter_expected_elements;
     double bloom_filter_false_positive_rate;
+    double bloom_filter_bits_per_key;
+    std::string bloom_filter_allocation;
+    std::string bloom_filter_deep_level_type;
+    int bloom_filter_deep_level;
+    std::string bloom_filter_prefix_extractor;
+    bool bloom_filter_range_filter;
 };
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
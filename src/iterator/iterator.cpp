@@ -1,8 +1,8 @@
 #include "iterator.h"
 
 namespace LSMT {
-Item::Item(std::string key, std::string val, int index, int level, uint64_t trx_id)
-: key(key), val(val), index(index), level(level), trx_id(trx_id) { }
+Item::Item(std::string key, std::string val, int index, int level, uint64_t trx_id, bool blob_index)
+: key(key), val(val), index(index), level(level), trx_id(trx_id), blob_index(blob_index) { }
 
 bool Item::operator<(const Item &other) const {
     if (key != other.key) {
@@ -92,6 +92,10 @@ bool HeapIterator::is_vld() const {
     return pqueue.empty() != true;
 }
 
+bool HeapIterator::is_blob_index() const {
+    return !pqueue.empty() && pqueue.top().blob_index;
+}
+
 bool HeapIterator::check_item_valid() {
     if (pqueue.empty()) {
         return true;
@@ -38,6 +38,9 @@ public:
     virtual bool is_end() const = 0;
 
     virtual bool is_vld() const = 0;
+
+    // 当前值是否为未解析的BlobIndex 只有合并时的迭代器会返回true
+    virtual bool is_blob_index() const { return false; }
 };
 
 struct Item {
@@ -46,10 +49,11 @@ struct Item {
     uint64_t trx_id;
     int index;
     int level;
+    bool blob_index = false;
 
     Item() = default;
     
-    Item(std::string key, std::string val, int index, int level, uint64_t trx_id);
+    Item(std::string key, std::string val, int index, int level, uint64_t trx_id, bool blob_index = false);
     
     bool operator<(const Item &other) const;
     
@@ -88,6 +92,8 @@ public:
 
     virtual bool is_vld() const override;
 
+    virtual bool is_blob_index() const override;
+
 private:
     bool check_item_valid();
 
@@ -1,14 +1,37 @@
 #include <algorithm>
+#include <cctype>
 #include <filesystem>
 #include <shared_mutex>
 
 #include "lsm_engine.h"
 
 namespace LSMT {
+// 文件名中的编号部分只能由数字组成 其余文件(如临时文件)跳过
+static bool is_number(const std::string &str) {
+    return !str.empty() && std::all_of(str.begin(), str.end(), [](unsigned char c) { return std::isdigit(c); });
+}
+
 LSMTEngine::LSMTEngine(std::string path) : lsmt_path(path) {
-    block_cache = std::make_shared<BlockCache>(
-        TomlConfig::get_instance().get_lsm_block_cache_size(),
-        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+    // 开启索引和过滤器缓存时 从块缓存容量中预留高优先级池 数据块只使用剩余容量
+    // 比例限制在[0, 1]内 且至少为数据块保留一个块的容量
+    size_t cache_size = TomlConfig::get_instance().get_lsm_block_cache_size();
+    if (TomlConfig::get_instance().get_lsm_cache_index_and_filter()) {
+        double ratio = std::clamp(TomlConfig::get_instance().get_lsm_high_priority_pool_ratio(), 0.0, 1.0);
+        size_t high_pool_size = std::min(static_cast<size_t>(cache_size * ratio), cache_size > 0 ? cache_size - 1 : 0);
+        meta_cache = std::make_shared<MetaCache>(high_pool_size * TomlConfig::get_instance().get_lsm_block_size());
+        cache_size -= high_pool_size;
+    }
+
+    auto admission = to_cache_admission(TomlConfig::get_instance().get_lsm_block_cache_admission());
+    if (TomlConfig::get_instance().get_lsm_block_cache_policy() == "clock") {
+        block_cache = std::make_shared<ClockCache>(cache_size, admission);
+    } else {
+        block_cache = std::make_shared<BlockCache>(
+            cache_size, TomlConfig::get_instance().get_lsm_block_cache_lruk(), admission);
+    }
+    prepopulate = to_cache_prepopulate(TomlConfig::get_instance().get_lsm_block_cache_prepopulate());
+    prefix_extractor = PrefixExtractor::create(TomlConfig::get_instance().get_bloom_filter_prefix_extractor());
+    blob_storage = std::make_shared<BlobStorage>(lsmt_path, TomlConfig::get_instance().get_lsm_blob_gc_ratio());
     
     if (std::filesystem::exists(lsmt_path) == false) {
         std::filesystem::create_directory(lsmt_path);
@@ -24,6 +47,14 @@ LSMTEngine::LSMTEngine(std::string path) : lsmt_path(path) {
         }
 
         std::string filename = entry.path().filename().string();
+        if (filename.substr(0, 5) == "blob_") {
+            if (!is_number(filename.substr(5))) {
+                continue;
+            }
+            size_t file_id = std::stoull(filename.substr(5));
+            blob_storage->add_file(BlobFile::open(file_id, FileObj::open(entry.path().string(), false)));
+            continue;
+        }
         if (filename.substr(0, 4) != "sst_") {
             continue;
         }
@@ -35,7 +66,7 @@ LSMTEngine::LSMTEngine(std::string path) : lsmt_path(path) {
 
         const std::string index_str = filename.substr(4, dot_pos - 4);
         const std::string level_str = filename.substr(dot_pos + 1, filename.length() - dot_pos - 1);
-        if (index_str.empty() || level_str.empty()) {
+        if (!is_number(index_str) || !is_number(level_str)) {
             continue;
         }
         size_t sst_index = std::stoull(index_str);
@@ -44,6 +75,8 @@ LSMTEngine::LSMTEngine(std::string path) : lsmt_path(path) {
         std::unique_lock<std::shared_mutex> lsmt_lock(lsmt_mutex);
 
         auto sst = SST::open(sst_index, FileObj::open(entry.path().string(), false), block_cache);
+        attach_meta_cache(sst, sst_level);
+        attach_blob_storage(sst);
         ssts[sst_index] = sst;
         sst_indexes[sst_level].push_back(sst_index);
         curr_max_level = std::max(curr_max_level, sst_level);
@@ -56,6 +89,9 @@ LSMTEngine::LSMTEngine(std::string path) : lsmt_path(path) {
             std::reverse(sst_id_list.begin(), sst_id_list.end());
         }
     }
+
+    // 统计完所有SST的引用后 删除合并中途退出时遗留的Blob文件
+    blob_storage->remove_unreferenced();
 }
 
 std::optional<std::pair<std::string, uint64_t>> LSMTEngine::get(const std::string &key, uint64_t trx_id) {
@@ -191,8 +227,15 @@ uint64_t LSMTEngine::remove(const std::vector<std::string> &keys, uint64_t trx_i
 
 void LSMTEngine::clear() {
     memtable.clear();
+    for (auto &[sst_index, sst] : ssts) {
+        block_cache->erase_sst(sst_index);
+        if (meta_cache != nullptr) {
+            meta_cache->erase(sst_index);
+        }
+    }
     sst_indexes.clear();
     ssts.clear();
+    blob_storage->clear();
     try {
         for (const auto &entry : std::filesystem::directory_iterator(lsmt_path)) {
             if (!entry.is_regular_file()) {
@@ -219,10 +262,21 @@ uint64_t LSMTEngine::flush() {
     size_t new_sst_id = next_sst_index++;
 
     SSTBuilder builder = SSTBuilder(TomlConfig::get_instance().get_lsm_block_size(), true);
+    builder.set_bits_per_key(get_filter_bits_per_key(0));
+    builder.set_filter_type(get_filter_type(0));
+    builder.set_hash_index(use_hash_index(0));
+    builder.set_compression(get_compression_type(0));
+    builder.set_blob_storage(blob_storage, std::max(TomlConfig::get_instance().get_lsm_blob_min_size(), 0));
+    // 新刷盘的数据没有历史热点信息 只要开启预热就以低优先级填充缓存空闲容量
+    if (prepopulate != CachePrepopulate::NONE) {
+        builder.set_prepopulate(CachePrepopulate::ALL, block_cache);
+    }
 
     std::vector<uint64_t> trx_ids;
     auto sst_path = get_sst_path(new_sst_id, 0);
     auto new_sst = memtable.flush(builder, sst_path, new_sst_id, trx_ids, block_cache);
+    attach_meta_cache(new_sst, 0);
+    attach_blob_storage(new_sst);
 
     ssts[new_sst_id] = new_sst;
     sst_indexes[0].push_front(new_sst_id);
@@ -249,13 +303,15 @@ void LSMTEngine::compact(size_t src_level, size_t dst_level) {
         new_ssts = zone_compact(src_indexes_vec, dst_indexes_vec, dst_level);
     }
 
-    // 删除旧SSTable文件和内存中SSTable的索引信息
+    // 删除旧SSTable文件和内存中SSTable的索引信息 新SST已登记引用 不再被引用的Blob文件随之删除
     for (auto &src_index : src_indexes) {
         ssts[src_index]->remove();
+        blob_storage->release_references(ssts[src_index]->get_blob_refs());
         ssts.erase(src_index);
     }
     for (auto &dst_index : dst_indexes) {
         ssts[dst_index]->remove();
+        blob_storage->release_references(ssts[dst_index]->get_blob_refs());
         ssts.erase(dst_index);
     }
     sst_indexes[src_level].clear();
@@ -273,11 +329,12 @@ void LSMTEngine::compact(size_t src_level, size_t dst_level) {
 
 std::vector<std::shared_ptr<SST>> LSMTEngine::full_compact(std::vector<size_t> &src_indexes, 
         std::vector<size_t> &dst_indexes, size_t dst_level) {
+    auto priority = to_cache_priority(TomlConfig::get_instance().get_lsm_compaction_cache_priority());
     // 获取src_level中所有SSTable并合并为HeapIterator
     std::vector<SSTIterator> src_iters;
     src_iters.reserve(src_indexes.size());
     for (auto &src_index : src_indexes) {
-        src_iters.push_back(ssts[src_index]->begin(0));
+        src_iters.push_back(ssts[src_index]->begin(0, priority, false));
     }
     auto src_heap_pair = SSTIterator::merge_sst_iterator(std::move(src_iters), 0);
     auto src_iter_ptr = std::make_shared<HeapIterator>(std::move(src_heap_pair.first));
@@ -287,46 +344,78 @@ std::vector<std::shared_ptr<SST>> LSMTEngine::full_compact(std::vector<size_t> &
     for (auto &dst_index : dst_indexes) {
         dst_ssts.push_back(ssts[dst_index]);
     }
-    auto dst_iter_ptr = std::make_shared<ConcatIterator>(std::move(dst_ssts), 0);
+    auto dst_iter_ptr = std::make_shared<ConcatIterator>(std::move(dst_ssts), 0, priority, false);
     // 对src_level和dst_level的SSTable执行合并操作并返回新生成的SSTable
     TwoMergeIterator merge_iter(src_iter_ptr, dst_iter_ptr, 0);
-    return generate_ssts(merge_iter, get_sst_size(dst_level), dst_level);
+    auto hot_ranges = get_hot_ranges(src_indexes);
+    auto dst_hot_ranges = get_hot_ranges(dst_indexes);
+    hot_ranges.insert(hot_ranges.end(), dst_hot_ranges.begin(), dst_hot_ranges.end());
+    return generate_ssts(merge_iter, get_sst_size(dst_level), dst_level, hot_ranges);
 }
 
 std::vector<std::shared_ptr<SST>> LSMTEngine::zone_compact(std::vector<size_t> &src_indexes,
         std::vector<size_t> &dst_indexes, size_t dst_level) {
+    auto priority = to_cache_priority(TomlConfig::get_instance().get_lsm_compaction_cache_priority());
     // 获取src_level中所有SSTable并构造为ConcatIterator
     std::vector<std::shared_ptr<SST>> src_ssts;
     for (auto &src_index : src_indexes) {
         src_ssts.push_back(ssts[src_index]);
     }
-    auto src_iter_ptr = std::make_shared<ConcatIterator>(std::move(src_ssts), 0);
+    auto src_iter_ptr = std::make_shared<ConcatIterator>(std::move(src_ssts), 0, priority, false);
     // 获取dst_level中所有SSTable并构造为ConcatIterator
     std::vector<std::shared_ptr<SST>> dst_ssts;
     for (auto &dst_index : dst_indexes) {
         dst_ssts.push_back(ssts[dst_index]);
     }
-    auto dst_iter_ptr = std::make_shared<ConcatIterator>(std::move(dst_ssts), 0);
+    auto dst_iter_ptr = std::make_shared<ConcatIterator>(std::move(dst_ssts), 0, priority, false);
     // 对src_level和dst_level的SSTable执行合并操作并返回新生成的SSTable
     TwoMergeIterator merge_iter(src_iter_ptr, dst_iter_ptr, 0);
-    return generate_ssts(merge_iter, get_sst_size(dst_level), dst_level);
+    auto hot_ranges = get_hot_ranges(src_indexes);
+    auto dst_hot_ranges = get_hot_ranges(dst_indexes);
+    hot_ranges.insert(hot_ranges.end(), dst_hot_ranges.begin(), dst_hot_ranges.end());
+    return generate_ssts(merge_iter, get_sst_size(dst_level), dst_level, hot_ranges);
 }
 
-std::vector<std::shared_ptr<SST>> LSMTEngine::generate_ssts(BaseIterator &iter, size_t size, size_t level) {
+std::vector<std::shared_ptr<SST>> LSMTEngine::generate_ssts(BaseIterator &iter, size_t size, size_t level,
+        const std::vector<std::pair<std::string, std::string>> &hot_ranges) {
     std::vector<std::shared_ptr<SST>> new_ssts;
+    double bits_per_key = get_filter_bits_per_key(level);
+    FilterType filter_type = get_filter_type(level);
+    bool hash_index = use_hash_index(level);
+    CompressionType compression = get_compression_type(level);
+    size_t min_blob_size = std::max(TomlConfig::get_instance().get_lsm_blob_min_size(), 0);
     auto builder = SSTBuilder(TomlConfig::get_instance().get_lsm_block_size(), true);
+    builder.set_bits_per_key(bits_per_key);
+    builder.set_filter_type(filter_type);
+    builder.set_hash_index(hash_index);
+    builder.set_compression(compression);
+    builder.set_blob_storage(blob_storage, min_blob_size);
+    builder.set_prepopulate(prepopulate, block_cache, hot_ranges);
     
     while (iter.is_vld() && !iter.is_end()) {
         std::string curr_key = (*iter).first;
-        builder.add((*iter).first, (*iter).second, iter.get_trx_id());
+        // 合并迭代器不解析BlobIndex 值本身留在Blob文件中不再重写
+        if (iter.is_blob_index()) {
+            builder.add_blob_index((*iter).first, (*iter).second, iter.get_trx_id());
+        } else {
+            builder.add((*iter).first, (*iter).second, iter.get_trx_id());
+        }
         ++iter;
         if (!(iter.is_vld() && !iter.is_end() && (*iter).first == curr_key) &&
                 builder.estimated_size() >= size) {
             size_t new_sst_index = next_sst_index++;
             std::string sst_path = get_sst_path(new_sst_index, level);
             auto new_sst = builder.build(new_sst_index, sst_path, block_cache);
+            attach_meta_cache(new_sst, level);
+            attach_blob_storage(new_sst);
             new_ssts.push_back(new_sst);
             builder = SSTBuilder(TomlConfig::get_instance().get_lsm_block_size(), true);
+            builder.set_bits_per_key(bits_per_key);
+            builder.set_filter_type(filter_type);
+            builder.set_hash_index(hash_index);
+            builder.set_compression(compression);
+            builder.set_blob_storage(blob_storage, min_blob_size);
+            builder.set_prepopulate(prepopulate, block_cache, hot_ranges);
         }
     }
 
@@ -334,12 +423,41 @@ std::vector<std::shared_ptr<SST>> LSMTEngine::generate_ssts(BaseIterator &iter,
         size_t new_sst_index = next_sst_index++;
         std::string sst_path = get_sst_path(new_sst_index, level);
         auto new_sst = builder.build(new_sst_index, sst_path, block_cache);
+        attach_meta_cache(new_sst, level);
+        attach_blob_storage(new_sst);
         new_ssts.push_back(new_sst);
     }
 
     return new_ssts;
 }
 
+std::vector<std::pair<std::string, std::string>> LSMTEngine::get_hot_ranges(const std::vector<size_t> &indexes) {
+    // 合并前收集输入SST中仍被缓存的数据块键范围 新SST中覆盖这些范围的数据块视为热点
+    std::vector<std::pair<std::string, std::string>> hot_ranges;
+    if (prepopulate != CachePrepopulate::HOT) {
+        return hot_ranges;
+    }
+    for (auto &index : indexes) {
+        auto ranges = ssts[index]->get_cached_ranges();
+        hot_ranges.insert(hot_ranges.end(), ranges.begin(), ranges.end());
+    }
+    return hot_ranges;
+}
+
+void LSMTEngine::attach_meta_cache(std::shared_ptr<SST> sst, size_t level) {
+    // Level0和较上层的SST访问最频繁 其索引和过滤器固定在高优先级池中
+    if (meta_cache != nullptr) {
+        int pin_levels = TomlConfig::get_instance().get_lsm_pin_index_and_filter_levels();
+        sst->set_meta_cache(meta_cache, static_cast<int>(level) < pin_levels);
+    }
+}
+
+void LSMTEngine::attach_blob_storage(std::shared_ptr<SST> sst) {
+    // SST生效前登记其对Blob文件的引用 之后删除旧SST时才不会误删仍被引用的文件
+    sst->set_blob_storage(blob_storage);
+    blob_storage->add_references(sst->get_blob_refs());
+}
+
 std::string LSMTEngine::get_sst_path(size_t sst_index, size_t sst_level) {
     // 文件路径格式 lsmt_path/sst_<sst_index>.<sst_level>
     std::stringstream ss;
@@ -347,11 +465,112 @@ std::string LSMTEngine::get_sst_path(size_t sst_index, size_t sst_level) {
     return ss.str();
 }
 
+SSTProperties LSMTEngine::get_level_properties(size_t level) {
+    std::shared_lock<std::shared_mutex> rd_lock(lsmt_mutex);
+    SSTProperties level_properties;
+    auto it = sst_indexes.find(level);
+    if (it == sst_indexes.end()) {
+        return level_properties;
+    }
+    for (size_t sst_id : it->second) {
+        const SSTProperties *properties = ssts[sst_id]->get_properties();
+        if (properties != nullptr) {
+            level_properties.merge(*properties);
+        }
+    }
+    return level_properties;
+}
+
 size_t LSMTEngine::get_sst_size(size_t level) {
     return TomlConfig::get_instance().get_lsm_per_memtable_size() *
         static_cast<size_t>(std::pow(TomlConfig::get_instance().get_lsm_sst_level_ratio(), level));
 }
 
+std::vector<double> LSMTEngine::allocate_bits_per_key(const std::vector<double> &level_sizes, double bits_per_key) {
+    // Monkey: 在总内存不变的前提下最小化各层误判率之和 最优解为误判率与层大小成正比
+    // p_i = min(1, lambda * n_i) 二分查找lambda使总位数等于平均每键位数乘以总键数
+    const double ln2_square = std::pow(std::log(2), 2);
+    double total_size = 0;
+    for (double size : level_sizes) {
+        total_size += size;
+    }
+
+    auto bits_of = [&](double log_lambda, size_t level) {
+        double log_p = std::min(0.0, log_lambda + std::log(level_sizes[level]));
+        return -log_p / ln2_square;
+    };
+    auto total_bits_of = [&](double log_lambda) {
+        double total_bits = 0;
+        for (size_t level = 0; level < level_sizes.size(); ++level) {
+            total_bits += level_sizes[level] * bits_of(log_lambda, level);
+        }
+        return total_bits;
+    };
+
+    std::vector<double> result(level_sizes.size(), bits_per_key);
+    if (total_size <= 0 || bits_per_key <= 0) {
+        return result;
+    }
+    double lk = -std::log(*std::max_element(level_sizes.begin(), level_sizes.end())) - 100;
+    double rk = -std::log(*std::min_element(level_sizes.begin(), level_sizes.end()));
+    for (int i = 0; i < 100; ++i) {
+        double mid = lk + (rk - lk) / 2;
+        if (total_bits_of(mid) > bits_per_key * total_size) {
+            lk = mid;
+        } else {
+            rk = mid;
+        }
+    }
+    for (size_t level = 0; level < level_sizes.size(); ++level) {
+        result[level] = bits_of(rk, level);
+    }
+    return result;
+}
+
+double LSMTEngine::get_filter_bits_per_key(size_t level) {
+    double bits_per_key = TomlConfig::get_instance().get_bloom_filter_bits_per_key();
+    if (TomlConfig::get_instance().get_bloom_filter_allocation() != "monkey") {
+        return bits_per_key;
+    }
+    // 以各层现有SST的数量估计键数量 空层尚无数据 按该层容量(level_ratio个该层大小的SST)估计
+    std::vector<double> level_sizes;
+    for (size_t i = 0; i <= std::max(curr_max_level, level); ++i) {
+        auto it = sst_indexes.find(i);
+        size_t sst_number = it != sst_indexes.end() && !it->second.empty()
+            ? it->second.size() : static_cast<size_t>(TomlConfig::get_instance().get_lsm_sst_level_ratio());
+        level_sizes.push_back(static_cast<double>(get_sst_size(i)) * sst_number);
+    }
+    return allocate_bits_per_key(level_sizes, bits_per_key)[level];
+}
+
+FilterType LSMTEngine::get_filter_type(size_t level) {
+    // 深层SST只读且数量最多 用构建更慢但更省空间的静态过滤器
+    if (static_cast<int>(level) >= TomlConfig::get_instance().get_bloom_filter_deep_level()) {
+        return to_filter_type(TomlConfig::get_instance().get_bloom_filter_deep_level_type());
+    }
+    return FilterType::BLOCKED_BLOOM;
+}
+
+bool LSMTEngine::use_hash_index(size_t level) {
+    // 较上层的SST点查询最频繁 用少量空间换取块内查找免去二分
+    return static_cast<int>(level) < TomlConfig::get_instance().get_lsm_block_hash_index_levels();
+}
+
+CompressionType LSMTEngine::get_compression_type(size_t level) {
+    // 配置按层依次列出压缩算法 更深的层沿用最后一项
+    std::string config = TomlConfig::get_instance().get_lsm_block_compression();
+    size_t beg = 0;
+    for (size_t i = 0; i < level; ++i) {
+        size_t pos = config.find(',', beg);
+        if (pos == std::string::npos) {
+            break;
+        }
+        beg = pos + 1;
+    }
+    size_t end = config.find(',', beg);
+    return to_compression_type(config.substr(beg, end == std::string::npos ? std::string::npos : end - beg));
+}
+
 LevelIterator LSMTEngine::begin(uint64_t trx_id) {
     return LevelIterator(shared_from_this(), trx_id);
 }
@@ -362,6 +581,42 @@ LevelIterator LSMTEngine::end() {
 
 std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
 LSMTEngine::iter_monotony_predicate(uint64_t trx_id, std::function<int(const std::string&)> predicate) {
+    return merge_monotony_predicate(trx_id, predicate, nullptr);
+}
+
+std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+LSMTEngine::iters_preffix(const std::string &preffix, uint64_t trx_id) {
+    auto predicate = [preffix](const std::string &key) {
+        if (key.compare(0, preffix.size(), preffix) == 0) {
+            return 0;
+        }
+        return key < preffix ? 1 : -1;
+    };
+    // 跳过键范围不覆盖该前缀 或前缀过滤器判定不包含该前缀的SST
+    auto sst_filter = [this, &preffix](const std::shared_ptr<SST> &sst) {
+        return sst->may_contain_preffix(preffix, prefix_extractor);
+    };
+    return merge_monotony_predicate(trx_id, predicate, sst_filter);
+}
+
+std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+LSMTEngine::iters_range(const std::string &lower, const std::string &upper, uint64_t trx_id) {
+    auto predicate = [lower, upper](const std::string &key) {
+        if (key < lower) {
+            return 1;
+        }
+        return key > upper ? -1 : 0;
+    };
+    // 跳过键范围不相交 或范围过滤器判定该范围内没有键的SST
+    auto sst_filter = [&lower, &upper](const std::shared_ptr<SST> &sst) {
+        return sst->may_contain_range(lower, upper);
+    };
+    return merge_monotony_predicate(trx_id, predicate, sst_filter);
+}
+
+std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+LSMTEngine::merge_monotony_predicate(uint64_t trx_id, std::function<int(const std::string&)> predicate,
+        std::function<bool(const std::shared_ptr<SST>&)> sst_filter) {
     // 获取MemTable中满足单调性谓词的迭代器
     auto memtable_result = memtable.iters_monotony_predicate(trx_id, predicate);
 
@@ -369,6 +624,9 @@ LSMTEngine::iter_monotony_predicate(uint64_t trx_id, std::function<int(const std
     std::vector<Item> items;
     for (auto &[level, indexes] : sst_indexes) {
         for (auto &index : indexes) {
+            if (sst_filter != nullptr && !sst_filter(ssts[index])) {
+                continue;
+            }
             auto sst_result = ssts[index]->iters_monotony_predicate(trx_id, predicate);
             if (!sst_result.has_value()) {
                 continue;
@@ -462,6 +720,16 @@ LSMTree::iter_monotony_predicate(uint64_t trx_id, std::function<int(const std::s
     return engine->iter_monotony_predicate(trx_id, predicate);
 }
 
+std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+LSMTree::iters_preffix(const std::string &preffix, uint64_t trx_id) {
+    return engine->iters_preffix(preffix, trx_id);
+}
+
+std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+LSMTree::iters_range(const std::string &lower, const std::string &upper, uint64_t trx_id) {
+    return engine->iters_range(lower, upper, trx_id);
+}
+
 void LSMTree::clear() {
     engine->clear();
 }
@@ -11,6 +11,8 @@
 
 #include "lsm_iterator.h"
 
+#include "block/clock_cache.h"
+#include "block/meta_cache.h"
 #include "config/config.h"
 #include "iterator/iterator.h"
 #include "memtable/memtable.h"
@@ -55,9 +57,24 @@ public:
     std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
     iter_monotony_predicate(uint64_t trx_id, std::function<int(const std::string&)> predicate);
 
+    std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+    iters_preffix(const std::string &preffix, uint64_t trx_id);
+
+    std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+    iters_range(const std::string &lower, const std::string &upper, uint64_t trx_id);
+
+    // 汇总level层所有SST的统计信息 用于估算数据量 不扫描数据块 版本4之前的SST没有统计信息 不计入
+    SSTProperties get_level_properties(size_t level);
+
     static size_t get_sst_size(size_t level);
 
+    static std::vector<double> allocate_bits_per_key(const std::vector<double> &level_sizes, double bits_per_key);
+
 private:
+    std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+    merge_monotony_predicate(uint64_t trx_id, std::function<int(const std::string&)> predicate,
+        std::function<bool(const std::shared_ptr<SST>&)> sst_filter);
+
     void compact(size_t src_level, size_t dst_level);
 
     std::vector<std::shared_ptr<SST>> full_compact(std::vector<size_t> &src_indexes, 
@@ -66,14 +83,33 @@ private:
     std::vector<std::shared_ptr<SST>> zone_compact(std::vector<size_t> &src_indexes,
         std::vector<size_t> &dst_indexes, size_t dst_level);
 
-    std::vector<std::shared_ptr<SST>> generate_ssts(BaseIterator &iter, size_t size, size_t level);
+    std::vector<std::shared_ptr<SST>> generate_ssts(BaseIterator &iter, size_t size, size_t level,
+        const std::vector<std::pair<std::string, std::string>> &hot_ranges);
+
+    std::vector<std::pair<std::string, std::string>> get_hot_ranges(const std::vector<size_t> &indexes);
+
+    void attach_meta_cache(std::shared_ptr<SST> sst, size_t level);
+
+    void attach_blob_storage(std::shared_ptr<SST> sst);
+
+    double get_filter_bits_per_key(size_t level);
+
+    FilterType get_filter_type(size_t level);
+
+    bool use_hash_index(size_t level);
+
+    CompressionType get_compression_type(size_t level);
 public:
     std::string lsmt_path;
     MemTable memtable;
     std::map<size_t, std::deque<size_t>> sst_indexes;
     std::unordered_map<size_t, std::shared_ptr<SST>> ssts;
     std::shared_mutex lsmt_mutex;
-    std::shared_ptr<BlockCache> block_cache;
+    std::shared_ptr<BaseCache> block_cache;
+    std::shared_ptr<MetaCache> meta_cache;
+    std::shared_ptr<PrefixExtractor> prefix_extractor;
+    std::shared_ptr<BlobStorage> blob_storage;
+    CachePrepopulate prepopulate;
     size_t next_sst_index = 0;
     size_t curr_max_level = 0;
 };
@@ -103,6 +139,12 @@ public:
     std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
     iter_monotony_predicate(uint64_t trx_id, std::function<int(const std::string&)> predicate);
 
+    std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+    iters_preffix(const std::string &preffix, uint64_t trx_id);
+
+    std::optional<std::pair<TwoMergeIterator, TwoMergeIterator>>
+    iters_range(const std::string &lower, const std::string &upper, uint64_t trx_id);
+
     void clear();
 
     void flush_one();
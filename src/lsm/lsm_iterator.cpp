@@ -2,10 +2,12 @@
 #include "lsm_iterator.h"
 
 namespace LSMT {
-ConcatIterator::ConcatIterator(std::vector<std::shared_ptr<SST>> ssts, uint64_t trx_id)
-    : ssts(ssts), sst_iter(nullptr, trx_id), curr_index(0), max_trx_id(trx_id) {
+ConcatIterator::ConcatIterator(std::vector<std::shared_ptr<SST>> ssts, uint64_t trx_id, CachePriority priority,
+        bool resolve_blob)
+    : ssts(ssts), sst_iter(nullptr, trx_id), curr_index(0), max_trx_id(trx_id), priority(priority),
+      resolve_blob(resolve_blob) {
     if (!this->ssts.empty()) {
-        sst_iter = ssts[0]->begin(max_trx_id);
+        sst_iter = ssts[0]->begin(max_trx_id, priority, resolve_blob);
     }
 }
 
@@ -22,7 +24,7 @@ BaseIterator &ConcatIterator::operator++() {
     if (sst_iter.is_end() || !sst_iter.is_vld()) {
         curr_index++;
         if (curr_index < ssts.size()) {
-            sst_iter = ssts[curr_index]->begin(max_trx_id);
+            sst_iter = ssts[curr_index]->begin(max_trx_id, priority, resolve_blob);
         } else {
             sst_iter = SSTIterator(nullptr, max_trx_id);
         }
@@ -58,6 +60,10 @@ bool ConcatIterator::is_vld() const {
     return !sst_iter.is_end() && sst_iter.is_vld();
 }
 
+bool ConcatIterator::is_blob_index() const {
+    return sst_iter.is_blob_index();
+}
+
 std::string ConcatIterator::get_key() {
     return sst_iter.get_key();
 }
@@ -198,6 +204,13 @@ bool TwoMergeIterator::is_vld() const {
     return iter_new->is_vld() || iter_old->is_vld();
 }
 
+bool TwoMergeIterator::is_blob_index() const {
+    if (is_end()) {
+        return false;
+    }
+    return choose_new ? iter_new->is_blob_index() : iter_old->is_blob_index();
+}
+
 
 
 LevelIterator::LevelIterator(std::shared_ptr<LSMTEngine> engine, uint64_t max_trx_id)
@@ -207,13 +220,14 @@ LevelIterator::LevelIterator(std::shared_ptr<LSMTEngine> engine, uint64_t max_tr
     auto memtable_it_ptr = std::make_shared<HeapIterator>(memtable_it);
     iters.push_back(memtable_it_ptr);
 
-    // 获取SSTable的迭代器指针
+    // 获取SSTable的迭代器指针 全量扫描以低优先级填充缓存 避免冲刷点查热点
+    auto priority = to_cache_priority(TomlConfig::get_instance().get_lsm_scan_cache_priority());
     for (auto &[level, sst_indexes] : engine->sst_indexes) {
         if (level == 0) {
             std::vector<Item> items;
             for (auto &sst_index : engine->sst_indexes[0]) {
                 auto sst = engine->ssts[sst_index];
-                for (auto it = sst->begin(max_trx_id); it.is_vld() && !it.is_end(); ++it) {
+                for (auto it = sst->begin(max_trx_id, priority); it.is_vld() && !it.is_end(); ++it) {
                     if (max_trx_id != 0 && it.get_trx_id() > max_trx_id) {
                         continue;
                     }
@@ -227,7 +241,7 @@ LevelIterator::LevelIterator(std::shared_ptr<LSMTEngine> engine, uint64_t max_tr
             for (auto sst_index : sst_indexes) {
                 ssts.push_back(engine->ssts[sst_index]);
             }
-            auto sstable_it_ptr = std::make_shared<ConcatIterator>(ssts, max_trx_id);
+            auto sstable_it_ptr = std::make_shared<ConcatIterator>(ssts, max_trx_id, priority);
             iters.push_back(sstable_it_ptr);
         }
     }
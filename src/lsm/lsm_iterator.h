@@ -14,7 +14,8 @@ class LSMTEngine;
 
 class ConcatIterator : public BaseIterator {
 public:
-    ConcatIterator(std::vector<std::shared_ptr<SST>> ssts, uint64_t trx_id);
+    ConcatIterator(std::vector<std::shared_ptr<SST>> ssts, uint64_t trx_id,
+        CachePriority priority = CachePriority::NORMAL, bool resolve_blob = true);
 
     IteratorItem* operator->() const;
 
@@ -33,6 +34,8 @@ public:
     virtual bool is_end() const override;
 
     virtual bool is_vld() const override;
+
+    virtual bool is_blob_index() const override;
     
     std::string get_key();
 
@@ -43,6 +46,8 @@ private:
     size_t curr_index;
     std::vector<std::shared_ptr<SST>> ssts;
     uint64_t max_trx_id;
+    CachePriority priority;
+    bool resolve_blob;
 };
 
 class TwoMergeIterator : public BaseIterator {
@@ -69,6 +74,8 @@ public:
 
     virtual bool is_vld() const override;
 
+    virtual bool is_blob_index() const override;
+
     bool choose_iter_new();
 
     void skip_iter_old();
@@ -148,7 +148,7 @@ void MemTable::clear() {
 }
 
 std::shared_ptr<SST> MemTable::flush(SSTBuilder &builder, std::string &sst_path, size_t sst_index, 
-std::vector<uint64_t> &trx_ids, std::shared_ptr<BlockCache> block_cache) {
+std::vector<uint64_t> &trx_ids, std::shared_ptr<BaseCache> block_cache) {
     std::unique_lock<std::shared_mutex> frozen_lock(frozen_mutex);
 
     if (frozen_tables.empty()) {
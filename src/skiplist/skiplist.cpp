@@ -181,7 +181,8 @@ SkipList::iters_monotony_predicate(std::function<int(const std::string &)> predi
             }
         }
     }
-    if (predicate(current->next[0]->key) != 0) { 
+    // 所有节点都小于谓词区间时 next[0]为空
+    if (current->next[0] == nullptr || predicate(current->next[0]->key) != 0) { 
         return std::nullopt; 
     }
     SkipListIterator beg_iter = SkipListIterator(current->next[0]);
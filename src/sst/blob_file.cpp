@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "blob_file.h"
+#include "utils/coding.h"
+#include "utils/crc32c.h"
+
+namespace LSMT {
+std::string BlobIndex::encode() const {
+    std::vector<uint8_t> encoded;
+    put_varint(encoded, file_id);
+    put_varint(encoded, offset);
+    put_varint(encoded, size);
+    return std::string(encoded.begin(), encoded.end());
+}
+
+BlobIndex BlobIndex::decode(std::string_view encoded) {
+    BlobIndex index;
+    const uint8_t *pointer = reinterpret_cast<const uint8_t*>(encoded.data());
+    const uint8_t *limit = pointer + encoded.size();
+    pointer = decode_varint(pointer, limit, index.file_id);
+    pointer = pointer == nullptr ? nullptr : decode_varint(pointer, limit, index.offset);
+    pointer = pointer == nullptr ? nullptr : decode_varint(pointer, limit, index.size);
+    if (pointer != limit) {
+        throw std::runtime_error("Corrupted Blob Index");
+    }
+    return index;
+}
+
+std::shared_ptr<BlobFile> BlobFile::open(uint64_t file_id, FileObj file_obj) {
+    auto blob_file = std::make_shared<BlobFile>();
+    blob_file->file_id = file_id;
+    blob_file->file_size = file_obj.size();
+    blob_file->file_obj = std::move(file_obj);
+    return blob_file;
+}
+
+std::string BlobFile::get(const BlobIndex &index, std::string_view key) {
+    if (index.offset + index.size > file_size || index.size <= sizeof(uint32_t)) {
+        throw std::runtime_error("Blob Index Out Of File Range");
+    }
+    std::vector<uint8_t> record;
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        record = file_obj.read(index.offset, index.size);
+    }
+
+    // 校验整条记录
+    size_t payload_size = record.size() - sizeof(uint32_t);
+    uint32_t hash_value;
+    memcpy(&hash_value, record.data() + payload_size, sizeof(uint32_t));
+    if (hash_value != crc32c(record.data(), payload_size)) {
+        throw std::runtime_error("Blob Record Hash Verification Error");
+    }
+
+    // 依次解析key和val
+    const uint8_t *pointer = record.data();
+    const uint8_t *limit = record.data() + payload_size;
+    uint64_t key_len, val_len;
+    pointer = decode_varint(pointer, limit, key_len);
+    if (pointer == nullptr || key_len > static_cast<uint64_t>(limit - pointer) ||
+            std::string_view(reinterpret_cast<const char*>(pointer), key_len) != key) {
+        throw std::runtime_error("Blob Record Key Mismatch");
+    }
+    pointer = decode_varint(pointer + key_len, limit, val_len);
+    if (pointer == nullptr || val_len != static_cast<uint64_t>(limit - pointer)) {
+        throw std::runtime_error("Corrupted Blob Record");
+    }
+    return std::string(reinterpret_cast<const char*>(pointer), val_len);
+}
+
+uint64_t BlobFile::get_file_id() const {
+    return file_id;
+}
+
+size_t BlobFile::get_file_size() const {
+    return file_size;
+}
+
+void BlobFile::remove() {
+    std::lock_guard<std::mutex> lock(file_mutex);
+    file_obj.remove();
+}
+
+
+
+BlobFileBuilder::BlobFileBuilder(uint64_t file_id) : file_id(file_id) { }
+
+BlobIndex BlobFileBuilder::add(const std::string &key, const std::string &val) {
+    BlobIndex index;
+    index.file_id = file_id;
+    index.offset = data.size();
+
+    put_varint(data, key.size());
+    data.insert(data.end(), key.begin(), key.end());
+    put_varint(data, val.size());
+    data.insert(data.end(), val.begin(), val.end());
+    uint32_t hash_value = crc32c(data.data() + index.offset, data.size() - index.offset);
+    data.resize(data.size() + sizeof(uint32_t));
+    memcpy(data.data() + data.size() - sizeof(uint32_t), &hash_value, sizeof(uint32_t));
+
+    index.size = data.size() - index.offset;
+    return index;
+}
+
+uint64_t BlobFileBuilder::get_file_id() const {
+    return file_id;
+}
+
+bool BlobFileBuilder::is_empty() const {
+    return data.empty();
+}
+
+std::shared_ptr<BlobFile> BlobFileBuilder::build(const std::string &path) {
+    FileObj file_obj = FileObj::create_and_write(path, data);
+    if (!file_obj.sync()) {
+        throw std::runtime_error("Failed To Sync File " + path);
+    }
+    return BlobFile::open(file_id, std::move(file_obj));
+}
+
+
+
+BlobStorage::BlobStorage(std::string path, double gc_ratio) : path(path), gc_ratio(gc_ratio) { }
+
+std::string BlobStorage::get_blob_path(uint64_t file_id) const {
+    // 文件路径格式 path/blob_<file_id>
+    std::stringstream ss;
+    ss << path << "/blob_" << std::setfill('0') << std::setw(32) << file_id;
+    return ss.str();
+}
+
+uint64_t BlobStorage::new_file_id() {
+    std::unique_lock<std::shared_mutex> lock(storage_mutex);
+    return next_file_id++;
+}
+
+void BlobStorage::add_file(std::shared_ptr<BlobFile> blob_file) {
+    std::unique_lock<std::shared_mutex> lock(storage_mutex);
+    next_file_id = std::max(next_file_id, blob_file->get_file_id() + 1);
+    blob_files[blob_file->get_file_id()].blob_file = blob_file;
+}
+
+std::string BlobStorage::get(const BlobIndex &index, std::string_view key) {
+    std::shared_ptr<BlobFile> blob_file;
+    {
+        std::shared_lock<std::shared_mutex> lock(storage_mutex);
+        auto it = blob_files.find(index.file_id);
+        if (it == blob_files.end() || it->second.blob_file == nullptr) {
+            throw std::runtime_error("Blob File " + std::to_string(index.file_id) + " Not Found");
+        }
+        blob_file = it->second.blob_file;
+    }
+    return blob_file->get(index, key);
+}
+
+void BlobStorage::add_references(const std::map<uint64_t, uint64_t> &refs) {
+    std::unique_lock<std::shared_mutex> lock(storage_mutex);
+    for (const auto &[file_id, bytes] : refs) {
+        blob_files[file_id].referenced_bytes += bytes;
+    }
+}
+
+void BlobStorage::release_references(const std::map<uint64_t, uint64_t> &refs) {
+    std::unique_lock<std::shared_mutex> lock(storage_mutex);
+    for (const auto &[file_id, bytes] : refs) {
+        auto it = blob_files.find(file_id);
+        if (it == blob_files.end()) {
+            continue;
+        }
+        it->second.referenced_bytes -= std::min(bytes, it->second.referenced_bytes);
+        if (it->second.referenced_bytes == 0) {
+            if (it->second.blob_file != nullptr) {
+                it->second.blob_file->remove();
+            }
+            blob_files.erase(it);
+        }
+    }
+}
+
+void BlobStorage::remove_unreferenced() {
+    std::unique_lock<std::shared_mutex> lock(storage_mutex);
+    for (auto it = blob_files.begin(); it != blob_files.end();) {
+        if (it->second.referenced_bytes == 0 && it->second.blob_file != nullptr) {
+            it->second.blob_file->remove();
+            it = blob_files.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool BlobStorage::need_relocate(uint64_t file_id) const {
+    return gc_ratio > 0 && get_garbage_ratio(file_id) >= gc_ratio;
+}
+
+double BlobStorage::get_garbage_ratio(uint64_t file_id) const {
+    std::shared_lock<std::shared_mutex> lock(storage_mutex);
+    auto it = blob_files.find(file_id);
+    if (it == blob_files.end() || it->second.blob_file == nullptr || it->second.blob_file->get_file_size() == 0) {
+        return 0.0;
+    }
+    double referenced = static_cast<double>(it->second.referenced_bytes) / it->second.blob_file->get_file_size();
+    return std::max(0.0, 1.0 - referenced);
+}
+
+size_t BlobStorage::get_file_number() const {
+    std::shared_lock<std::shared_mutex> lock(storage_mutex);
+    return blob_files.size();
+}
+
+void BlobStorage::clear() {
+    std::unique_lock<std::shared_mutex> lock(storage_mutex);
+    blob_files.clear();
+}
+} // LOG STRUCTURED MERGE TREE
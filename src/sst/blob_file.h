@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/files.h"
+
+/***
+-----------------------------------------------
+|                  Blob File                  |
+-----------------------------------------------
+| Record 1 | Record 2 | ... | Record N |
+-----------------------------------------------
+
+--------------------------------------------------------------------------------
+|                                    Record                                    |
+--------------------------------------------------------------------------------
+| key_len(varint) | key(key_len) | val_len(varint) | val(val_len) | CRC32C(4B) |
+--------------------------------------------------------------------------------
+CRC32C覆盖key_len到val的全部内容 读取时同时校验key 防止BlobIndex指向错误的记录
+
+-------------------------------------------------
+|                  BlobIndex                    |
+-------------------------------------------------
+| file_id(varint) | offset(varint) | size(varint) |
+-------------------------------------------------
+较大的值写入只追加的Blob文件 SST中只保存指向整条Record的BlobIndex
+合并时BlobIndex原样写入新SST 值本身不再重复读写
+***/
+
+namespace LSMT {
+struct BlobIndex {
+    uint64_t file_id = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+
+    std::string encode() const;
+
+    static BlobIndex decode(std::string_view encoded);
+};
+
+class BlobFile {
+public:
+    static std::shared_ptr<BlobFile> open(uint64_t file_id, FileObj file_obj);
+
+    // 读取index指向的记录并返回值 校验失败或key不匹配时抛出异常
+    std::string get(const BlobIndex &index, std::string_view key);
+
+    uint64_t get_file_id() const;
+
+    size_t get_file_size() const;
+
+    void remove();
+
+private:
+    uint64_t file_id;
+    size_t file_size;
+    FileObj file_obj;
+    std::mutex file_mutex;  // 文件读取需要先定位 不能并发
+};
+
+class BlobFileBuilder {
+public:
+    BlobFileBuilder(uint64_t file_id);
+
+    BlobIndex add(const std::string &key, const std::string &val);
+
+    uint64_t get_file_id() const;
+
+    bool is_empty() const;
+
+    std::shared_ptr<BlobFile> build(const std::string &path);
+
+private:
+    uint64_t file_id;
+    std::vector<uint8_t> data;
+};
+
+/***
+管理目录下的所有Blob文件 按SST中的BlobIndex统计每个文件仍被引用的字节数
+垃圾比例 = 1 - 被引用字节数 / 文件大小 达到gc_ratio的文件在合并时把仍有效的值迁移到新文件
+不再被任何SST引用的文件直接删除
+***/
+class BlobStorage {
+public:
+    BlobStorage(std::string path, double gc_ratio);
+
+    std::string get_blob_path(uint64_t file_id) const;
+
+    uint64_t new_file_id();
+
+    void add_file(std::shared_ptr<BlobFile> blob_file);
+
+    std::string get(const BlobIndex &index, std::string_view key);
+
+    // refs为file_id到被引用字节数的映射 新SST生效前增加 旧SST删除后释放
+    void add_references(const std::map<uint64_t, uint64_t> &refs);
+
+    void release_references(const std::map<uint64_t, uint64_t> &refs);
+
+    // 删除没有被引用的文件 打开目录并统计完所有SST的引用后调用
+    void remove_unreferenced();
+
+    // 合并时是否需要把该文件中的值迁移到新文件 gc_ratio不大于0时从不迁移
+    bool need_relocate(uint64_t file_id) const;
+
+    double get_garbage_ratio(uint64_t file_id) const;
+
+    size_t get_file_number() const;
+
+    void clear();
+
+private:
+    struct BlobFileState {
+        std::shared_ptr<BlobFile> blob_file;
+        uint64_t referenced_bytes = 0;
+    };
+
+    std::string path;
+    double gc_ratio;
+    uint64_t next_file_id = 0;
+    std::map<uint64_t, BlobFileState> blob_files;
+    mutable std::shared_mutex storage_mutex;
+};
+} // LOG STRUCTURED MERGE TREE
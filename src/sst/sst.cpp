@@ -1,77 +1,352 @@
 #include "sst.h"
 #include "sst_iterator.h"
+#include "config/config.h"
 
 namespace LSMT {
-std::shared_ptr<SST> SST::open(size_t sst_id, FileObj file_obj, std::shared_ptr<BlockCache> block_cache) {
+std::vector<uint8_t> SSTFooter::encode() const {
+    std::vector<uint8_t> encoded(SIZE);
+    uint8_t *pointer = encoded.data();
+    for (uint64_t value : {properties_offset, meta_section_offset, filter_section_offset, min_trx_id, max_trx_id}) {
+        memcpy(pointer, &value, sizeof(uint64_t));
+        pointer += sizeof(uint64_t);
+    }
+    memcpy(pointer, &features, sizeof(uint32_t));
+    pointer += sizeof(uint32_t);
+    memcpy(pointer, &version, sizeof(uint32_t));
+    pointer += sizeof(uint32_t);
+    memcpy(pointer, &MAGIC, sizeof(uint64_t));
+    return encoded;
+}
+
+SSTFooter SSTFooter::read(FileObj &file_obj) {
+    SSTFooter footer;
+    size_t file_size = file_obj.size();
+    // 版本2和3的Footer只有V3_SIZE字节 版本4的长度在确定版本后再检查
+    uint64_t magic = 0;
+    if (file_size >= V3_SIZE) {
+        auto data = file_obj.read(file_size - sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&magic, data.data(), sizeof(uint64_t));
+    }
+
+    if (magic != MAGIC) {
+        // 版本1: 文件末尾为四个大端序整数
+        if (file_size < LEGACY_SIZE) {
+            throw std::runtime_error("SST File Too Small");
+        }
+        size_t read_position = file_size;
+        read_position -= sizeof(uint64_t);
+        footer.max_trx_id = file_obj.read_uint64(read_position);
+        read_position -= sizeof(uint64_t);
+        footer.min_trx_id = file_obj.read_uint64(read_position);
+        read_position -= sizeof(uint32_t);
+        footer.filter_section_offset = file_obj.read_uint32(read_position);
+        read_position -= sizeof(uint32_t);
+        footer.meta_section_offset = file_obj.read_uint32(read_position);
+        footer.version = 1;
+        footer.footer_size = LEGACY_SIZE;
+        return footer;
+    }
+
+    // 各版本的Version和Magic都位于文件末尾 版本4在版本3的Footer之前增加了Properties Offset
+    auto data = file_obj.read(file_size - V3_SIZE, V3_SIZE);
+    const uint8_t *pointer = data.data();
+    memcpy(&footer.version, pointer + 4 * sizeof(uint64_t) + sizeof(uint32_t), sizeof(uint32_t));
+    switch (footer.version) {
+    case 4:
+        if (file_size < SIZE) {
+            throw std::runtime_error("SST File Too Small");
+        }
+        memcpy(&footer.properties_offset, file_obj.read(file_size - SIZE, sizeof(uint64_t)).data(), sizeof(uint64_t));
+        [[fallthrough]];
+    case 2:
+    case 3:
+        memcpy(&footer.meta_section_offset, pointer, sizeof(uint64_t));
+        memcpy(&footer.filter_section_offset, pointer + sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&footer.min_trx_id, pointer + 2 * sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&footer.max_trx_id, pointer + 3 * sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&footer.features, pointer + 4 * sizeof(uint64_t), sizeof(uint32_t));
+        footer.footer_size = footer.version == 4 ? SIZE : V3_SIZE;
+        break;
+    default:
+        throw std::runtime_error("Unsupported SST Format Version " + std::to_string(footer.version));
+    }
+
+    if (footer.meta_section_offset > footer.filter_section_offset ||
+            footer.filter_section_offset > footer.get_filter_section_end(file_size) ||
+            footer.get_filter_section_end(file_size) > file_size - footer.footer_size) {
+        throw std::runtime_error("Corrupted SST Footer");
+    }
+    return footer;
+}
+
+uint64_t SSTFooter::get_filter_section_end(size_t file_size) const {
+    return properties_offset != 0 ? properties_offset : file_size - footer_size;
+}
+
+std::shared_ptr<SST> SST::open(size_t sst_id, FileObj file_obj, std::shared_ptr<BaseCache> block_cache) {
     auto sst = std::make_shared<SST>();
     sst->sst_id = sst_id;
     sst->file_obj = std::move(file_obj);
     sst->block_cache = block_cache;
 
-    size_t read_position = sst->file_obj.size();
+    // 读取Footer
+    sst->footer = SSTFooter::read(sst->file_obj);
 
-    // 读取EXTRA INFORMATION
-    read_position -= sizeof(uint64_t);
-    sst->max_trx_id = sst->file_obj.read_uint64(read_position);
-    read_position -= sizeof(uint64_t);
-    sst->min_trx_id = sst->file_obj.read_uint64(read_position);
-    read_position -= sizeof(uint32_t);
-    sst->bloom_filter_offset = sst->file_obj.read_uint32(read_position);
-    read_position -= sizeof(uint32_t);
-    sst->meta_section_offset = sst->file_obj.read_uint32(read_position);
+    // 读取Bloom Filter和Meta Section
+    sst->meta = sst->load_meta();
+    const auto &partitions = sst->meta->partitions;
+    sst->block_number = sst->meta->meta_entries.size();
 
-    // 读取Bloom Filter
-    size_t bloom_filter_size = read_position - sst->bloom_filter_offset;
-    if (bloom_filter_size > 0) {
-        std::vector<uint8_t> data = sst->file_obj.read(sst->bloom_filter_offset, bloom_filter_size);
-        sst->filter = std::make_shared<BloomFilter>(BloomFilter::decode(data));
-    }
-
-    // 读取Meta Section
-    size_t meta_section_size = sst->bloom_filter_offset - sst->meta_section_offset;
-    if (meta_section_size > 0) {
-        std::vector<uint8_t> data = sst->file_obj.read(sst->meta_section_offset, meta_section_size);
-        BlockMeta::decode_meta(data, sst->meta_entries);
+    // 读取首Key值和尾Key值
+    if (!sst->meta->meta_entries.empty()) {
+        sst->fkey = sst->meta->meta_entries.front().fkey;
+        sst->lkey = sst->meta->meta_entries.back().lkey;
+    } else if (!partitions.empty()) {
+        sst->block_number = partitions.back().first_block + partitions.back().block_number;
+        sst->fkey = partitions.front().fkey;
+        sst->lkey = partitions.back().lkey;
     }
 
-    // 读取首Key值和尾Key值
-    if (!sst->meta_entries.empty()) {
-        sst->fkey = sst->meta_entries.front().fkey;
-        sst->lkey = sst->meta_entries.back().lkey;
+    // 读取统计信息 其中已记录Blob引用 旧版本文件只能扫描数据块
+    if (sst->footer.properties_offset != 0) {
+        size_t footer_offset = sst->file_obj.size() - sst->footer.footer_size;
+        sst->properties = std::make_unique<SSTProperties>(SSTProperties::decode(
+            sst->file_obj.read(sst->footer.properties_offset, footer_offset - sst->footer.properties_offset)));
+        sst->blob_refs = sst->properties->blob_refs;
+    } else if ((sst->footer.features & SST_FEATURE_BLOB_INDEX) != 0) {
+        sst->load_blob_refs();
     }
 
     return sst;
 }
 
 void SST::remove() {
+    // 删除SST文件时同步淘汰其在缓存中的数据块 避免失效数据块占用缓存容量
+    if (block_cache != nullptr) {
+        block_cache->erase_sst(sst_id);
+    }
+    if (meta_cache != nullptr) {
+        meta_cache->erase(sst_id);
+    }
     file_obj.remove();
 }
 
+void SST::set_meta_cache(std::shared_ptr<MetaCache> meta_cache, bool pinned) {
+    this->meta_cache = meta_cache;
+    meta_cache->put(sst_id, meta, pinned);
+    if (!pinned) {
+        meta = nullptr;
+    }
+}
+
+void SST::set_blob_storage(std::shared_ptr<BlobStorage> blob_storage) {
+    this->blob_storage = blob_storage;
+}
+
+const std::map<uint64_t, uint64_t> &SST::get_blob_refs() const {
+    return blob_refs;
+}
+
+std::string SST::get_blob(std::string_view key, std::string_view blob_index) {
+    if (blob_storage == nullptr) {
+        throw std::runtime_error("Blob Storage Is Not Set");
+    }
+    return blob_storage->get(BlobIndex::decode(blob_index), key);
+}
+
+void SST::load_blob_refs() {
+    // 引用信息不单独保存 打开时遍历所有数据块 不经过块缓存
+    for (size_t block_id = 0; block_id < block_number; ++block_id) {
+        auto block = get_block(block_id, CachePriority::BYPASS);
+        for (size_t index = 0; index < block->get_entry_number(); ++index) {
+            if (block->is_blob_index(index)) {
+                BlobIndex blob_index = BlobIndex::decode(block->get_val_view(block->get_offset(index)));
+                blob_refs[blob_index.file_id] += blob_index.size;
+            }
+        }
+    }
+}
+
+std::shared_ptr<SSTMeta> SST::get_meta() {
+    if (meta != nullptr) {
+        return meta;
+    }
+    auto cached_meta = meta_cache->get(sst_id);
+    if (cached_meta == nullptr) {
+        // 索引和过滤器已被淘汰 重新从文件读取并放回缓存
+        cached_meta = load_meta();
+        meta_cache->put(sst_id, cached_meta);
+    }
+    return cached_meta;
+}
+
+std::shared_ptr<SSTMeta> SST::load_meta() {
+    auto loaded_meta = std::make_shared<SSTMeta>();
+    size_t filter_section_end = footer.get_filter_section_end(file_obj.size());
+
+    size_t bloom_filter_size = filter_section_end - footer.filter_section_offset;
+    if (bloom_filter_size > 0) {
+        std::vector<uint8_t> data = file_obj.read(footer.filter_section_offset, bloom_filter_size);
+        loaded_meta->filters = FilterSection::decode(data);
+    }
+
+    size_t meta_section_size = footer.filter_section_offset - footer.meta_section_offset;
+    if (meta_section_size > 0) {
+        std::vector<uint8_t> data = file_obj.read(footer.meta_section_offset, meta_section_size);
+        if ((footer.features & SST_FEATURE_LEARNED_INDEX) != 0) {
+            uint32_t learned_size = 0;
+            if (data.size() >= sizeof(uint32_t)) {
+                memcpy(&learned_size, data.data() + data.size() - sizeof(uint32_t), sizeof(uint32_t));
+            }
+            if (data.size() < sizeof(uint32_t) || learned_size > data.size() - sizeof(uint32_t)) {
+                throw std::runtime_error("Corrupted Learned Index");
+            }
+            size_t learned_offset = data.size() - sizeof(uint32_t) - learned_size;
+            loaded_meta->learned_index = LearnedIndex::decode(data.data() + learned_offset, learned_size);
+            data.resize(learned_offset);
+        }
+        if (is_index_partitioned()) {
+            IndexPartition::decode_partitions(data, loaded_meta->partitions);
+        } else {
+            BlockMeta::decode_meta(data, loaded_meta->meta_entries);
+        }
+        const auto &learned_index = loaded_meta->learned_index;
+        if (learned_index != nullptr && learned_index->get_block_number() != loaded_meta->meta_entries.size()) {
+            throw std::runtime_error("Corrupted Learned Index");
+        }
+    }
+
+    loaded_meta->charge = filter_section_end - footer.meta_section_offset;
+    return loaded_meta;
+}
+
+// 在按键范围有序且互不重叠的索引项中二分查找第一个上界不小于key的一项 key小于其下界或超出所有项时返回-1
+// 短分隔符格式中只比较上界 下界为空时不做检查 调用方已确定结果在[first, last)内时只在其中查找
+template<class Entry>
+static int64_t search_range(const std::vector<Entry> &entries, const std::string &key,
+                            size_t first = 0, size_t last = SIZE_MAX) {
+    auto end = entries.begin() + std::min(last, entries.size());
+    auto it = std::lower_bound(entries.begin() + first, end, key,
+        [](const Entry &entry, const std::string &key) { return entry.lkey < key; });
+    if (it == end || key < it->fkey) {
+        return -1;
+    }
+    return it - entries.begin();
+}
+
 int64_t SST::get_block_id(const std::string &key) {
-    if (filter && !filter->possibly_contain(key) || key < fkey || key > lkey) {
+    if (key < fkey || key > lkey) {
         return -1;
     }
+    auto sst_meta = get_meta();
+    auto &key_filter = sst_meta->filters.key_filter;
+    if (key_filter && !key_filter->possibly_contain(key)) {
+        return -1;
+    }
+    if (!is_index_partitioned()) {
+        // 学习索引预测的窗口两端都能确认时 结果一定在窗口内 否则回退到全量二分
+        const auto &meta_entries = sst_meta->meta_entries;
+        if (sst_meta->learned_index != nullptr) {
+            auto [first, last] = sst_meta->learned_index->predict(key);
+            if ((first == 0 || meta_entries[first - 1].lkey < key) &&
+                (last == meta_entries.size() || key <= meta_entries[last - 1].lkey)) {
+                return search_range(meta_entries, key, first, last);
+            }
+        }
+        return search_range(meta_entries, key);
+    }
+
+    // 先在顶层索引上定位分区 再在分区内找到最后一个首key不大于key的数据块
+    int64_t partition_id = search_range(sst_meta->partitions, key);
+    if (partition_id == -1) {
+        return -1;
+    }
+    auto partition = get_index_partition(partition_id, CachePriority::NORMAL);
+    if (has_short_separator()) {
+        // 分区内的key为各数据块的separator 第一个不小于key的即为可能包含key的数据块
+        size_t index = partition->lower_bound(key);
+        if (index == partition->get_entry_number()) {
+            return -1;
+        }
+        return sst_meta->partitions[partition_id].first_block + index;
+    }
+    size_t index = partition->upper_bound(key);
+    if (index == 0) {
+        return -1;
+    }
+    size_t block_size;
+    BlockMeta meta_entry = BlockMeta::decode_handle("", partition->get_val_view(partition->get_offset(index - 1)),
+        block_size);
+    if (key > meta_entry.lkey) {
+        return -1;
+    }
+    return sst_meta->partitions[partition_id].first_block + index - 1;
+}
 
-    int lk = 0, rk = meta_entries.size() - 1;
-    while (lk <= rk) {
-        int mid = lk + (rk - lk) / 2;
-        if (key >= meta_entries[mid].fkey && key <= meta_entries[mid].lkey) {
-            return mid;
-        } else if (key < meta_entries[mid].fkey) {
-            rk = mid - 1;
-        } else if (key > meta_entries[mid].lkey) {
-            lk = mid + 1;
+bool SST::is_index_partitioned() const {
+    return (footer.features & SST_FEATURE_PARTITIONED_INDEX) != 0;
+}
+
+bool SST::has_short_separator() const {
+    return (footer.features & SST_FEATURE_SHORT_SEPARATOR) != 0;
+}
+
+std::shared_ptr<Block> SST::get_index_partition(size_t partition_id, CachePriority priority) {
+    // 索引分区与数据块共用块缓存 使用负数编号区分
+    int cache_id = -1 - static_cast<int>(partition_id);
+    if (block_cache != nullptr) {
+        auto partition = block_cache->get(sst_id, cache_id, priority);
+        if (partition != nullptr) {
+            return partition;
+        }
+    }
+
+    auto sst_meta = get_meta();
+    const IndexPartition &index_partition = sst_meta->partitions[partition_id];
+    std::vector<uint8_t> data = file_obj.read(index_partition.offset, index_partition.size);
+    auto partition = Block::decode(data, true, TomlConfig::get_instance().get_lsm_block_verify_checksum());
+    if (partition->get_entry_number() != index_partition.block_number) {
+        throw std::runtime_error("Corrupted Index Partition");
+    }
+    if (block_cache != nullptr) {
+        block_cache->put(sst_id, cache_id, partition, priority);
+    }
+    return partition;
+}
+
+BlockMeta SST::get_block_meta(size_t block_id, size_t &block_size, CachePriority priority) {
+    auto sst_meta = get_meta();
+    if (!is_index_partitioned()) {
+        const auto &meta_entries = sst_meta->meta_entries;
+        if (block_id == meta_entries.size() - 1) {
+            block_size = footer.meta_section_offset - meta_entries[block_id].offset;
         } else {
-            // Nothing to do
+            block_size = meta_entries[block_id + 1].offset - meta_entries[block_id].offset;
         }
+        return meta_entries[block_id];
     }
 
-    return -1;
+    // 找到最后一个起始编号不大于block_id的分区
+    const auto &partitions = sst_meta->partitions;
+    auto it = std::upper_bound(partitions.begin(), partitions.end(), block_id,
+        [](size_t id, const IndexPartition &partition) { return id < partition.first_block; });
+    size_t partition_id = it - partitions.begin() - 1;
+    auto partition = get_index_partition(partition_id, priority);
+    size_t index = block_id - partitions[partition_id].first_block;
+    if (has_short_separator()) {
+        // 分区内的key为数据块的上界 只有第一个数据块的下界已知
+        BlockMeta meta_entry = BlockMeta::decode_handle(block_id == 0 ? fkey : "",
+            partition->get_val_view(partition->get_offset(index)), block_size);
+        meta_entry.lkey = partition->get_key(index);
+        return meta_entry;
+    }
+    return BlockMeta::decode_handle(partition->get_key(index), partition->get_val_view(partition->get_offset(index)),
+        block_size);
 }
     
-std::shared_ptr<Block> SST::get_block(size_t block_id) {
+std::shared_ptr<Block> SST::get_block(size_t block_id, CachePriority priority) {
     if (block_cache != nullptr) {
-        auto block = block_cache->get(sst_id, block_id);
+        auto block = block_cache->get(sst_id, block_id, priority);
         if (block != nullptr) {
             return block;
         }
@@ -79,20 +354,27 @@ std::shared_ptr<Block> SST::get_block(size_t block_id) {
         throw std::runtime_error("Block cache is not initialized");
     }
 
-    const BlockMeta meta_entry = meta_entries[block_id];
-
     size_t block_size;
-    if (block_id == meta_entries.size() - 1) {
-        block_size = meta_section_offset - meta_entry.offset;
-    } else {
-        block_size = meta_entries[block_id + 1].offset - meta_entry.offset;
-    }
+    const BlockMeta meta_entry = get_block_meta(block_id, block_size, priority);
 
+    // 块缓存中保存解压并校验后的数据块 命中时不需要重复解压和校验
     std::vector<uint8_t> data = file_obj.read(meta_entry.offset, block_size);
-    std::shared_ptr<Block> block = Block::decode(data);
+    if (data.empty()) {
+        throw std::runtime_error("Corrupted Block Section");
+    }
+    // 压缩类型字节由Footer版本标记 版本1的数据块没有该字节
+    auto compression = CompressionType::NONE;
+    if (footer.version >= 2) {
+        compression = static_cast<CompressionType>(data.back());
+        data.pop_back();
+    }
+    if (compression != CompressionType::NONE) {
+        data = uncompress(compression, data.data(), data.size());
+    }
+    std::shared_ptr<Block> block = Block::decode(data, true, TomlConfig::get_instance().get_lsm_block_verify_checksum());
 
     if (block_cache != nullptr) {
-        block_cache->put(sst_id, block_id, block);
+        block_cache->put(sst_id, block_id, block, priority);
     } else {
         throw std::runtime_error("Block cache is not initialized");
     }
@@ -101,7 +383,12 @@ std::shared_ptr<Block> SST::get_block(size_t block_id) {
 }
 
 SSTIterator SST::get(const std::string &key, uint64_t trx_id) {
-    if (key < fkey || key > lkey || (filter && !filter->possibly_contain(key))) {
+    if (key < fkey || key > lkey) {
+        return this->end();
+    }
+    auto sst_meta = get_meta();
+    auto &key_filter = sst_meta->filters.key_filter;
+    if (key_filter && !key_filter->possibly_contain(key)) {
         return this->end();
     }
     return SSTIterator(shared_from_this(), key, trx_id);
@@ -124,16 +411,16 @@ size_t SST::get_sst_size() const {
 }
 
 size_t SST::get_block_number() const {
-    return meta_entries.size();
+    return block_number;
 }
 
-SSTIterator SST::begin(uint64_t trx_id) {
-    return SSTIterator(shared_from_this(), trx_id);
+SSTIterator SST::begin(uint64_t trx_id, CachePriority priority, bool resolve_blob) {
+    return SSTIterator(shared_from_this(), trx_id, priority, resolve_blob);
 }
  
 SSTIterator SST::end() {
     SSTIterator iterator(shared_from_this(), 0);
-    iterator.block_id = meta_entries.size();
+    iterator.block_id = block_number;
     iterator.block_it = nullptr;
     return iterator;
 }
@@ -143,11 +430,27 @@ SST::iters_monotony_predicate(size_t trx_id, std::function<int(const std::string
     std::optional<SSTIterator> final_beg;
     std::optional<SSTIterator> final_end;
 
-    for (int block_id = 0; block_id < meta_entries.size(); block_id++) {
-        if (predicate(meta_entries[block_id].fkey) < 0) {
+    auto sst_meta = get_meta();
+    const auto &partitions = sst_meta->partitions;
+    for (size_t block_id = 0; block_id < block_number; block_id++) {
+        // 分区索引先按分区的键范围跳过整个分区
+        auto it = std::upper_bound(partitions.begin(), partitions.end(), block_id,
+            [](size_t id, const IndexPartition &partition) { return id < partition.first_block; });
+        if (it != partitions.begin() && (it - 1)->first_block == block_id) {
+            if (!(it - 1)->fkey.empty() && predicate((it - 1)->fkey) < 0) {
+                break;
+            }
+            if (predicate((it - 1)->lkey) > 0) {
+                block_id += (it - 1)->block_number - 1;
+                continue;
+            }
+        }
+        size_t block_size;
+        BlockMeta meta_entry = get_block_meta(block_id, block_size);
+        if (!meta_entry.fkey.empty() && predicate(meta_entry.fkey) < 0) {
             break;
         }
-        if (predicate(meta_entries[block_id].lkey) > 0) {
+        if (predicate(meta_entry.lkey) > 0) {
             continue;
         }
 
@@ -166,7 +469,11 @@ SST::iters_monotony_predicate(size_t trx_id, std::function<int(const std::string
             if (final_end->is_end() && final_end->block_id == get_block_number()) {
                 final_end = std::nullopt;
             }
-        }        
+        }
+        // 上界已超出范围时后续数据块的键都更大 短分隔符格式没有下界可以提前判断
+        if (predicate(meta_entry.lkey) < 0) {
+            break;
+        }
     }
 
     if (!final_beg.has_value() || !final_end.has_value()) {
@@ -175,7 +482,64 @@ SST::iters_monotony_predicate(size_t trx_id, std::function<int(const std::string
     return std::make_pair(final_beg.value(), final_end.value());
 }
 
+bool SST::may_contain_preffix(const std::string &preffix, const std::shared_ptr<PrefixExtractor> &extractor) {
+    // 键范围剪枝: 以preffix开头的键位于[preffix, preffix后继)之间
+    if (lkey < preffix || (fkey > preffix && fkey.compare(0, preffix.size(), preffix) != 0)) {
+        return false;
+    }
+    // 只有构建时使用了相同的前缀提取器 且查询前缀在提取器定义域内时才能使用前缀过滤器
+    if (extractor == nullptr || !extractor->in_domain(preffix)) {
+        return true;
+    }
+    auto sst_meta = get_meta();
+    auto &prefix_filter = sst_meta->filters.prefix_filter;
+    if (prefix_filter == nullptr || sst_meta->filters.prefix_extractor != extractor->get_name()) {
+        return true;
+    }
+    return prefix_filter->possibly_contain(extractor->transform(preffix));
+}
+
+bool SST::may_contain_range(const std::string &lower, const std::string &upper) {
+    if (lower > upper || lkey < lower || fkey > upper) {
+        return false;
+    }
+    auto sst_meta = get_meta();
+    auto &range_filter = sst_meta->filters.range_filter;
+    if (range_filter == nullptr) {
+        return true;
+    }
+    return range_filter->may_contain(lower, upper);
+}
+
 std::pair<uint64_t, uint64_t> SST::get_trx_id_range() const {
-    return std::make_pair(min_trx_id, max_trx_id);
+    return std::make_pair(footer.min_trx_id, footer.max_trx_id);
+}
+
+const SSTFooter &SST::get_footer() const {
+    return footer;
+}
+
+const SSTProperties *SST::get_properties() const {
+    return properties.get();
+}
+
+std::vector<std::pair<std::string, std::string>> SST::get_cached_ranges() {
+    std::vector<std::pair<std::string, std::string>> ranges;
+    if (block_cache == nullptr) {
+        return ranges;
+    }
+    for (int block_id : block_cache->cached_blocks(sst_id)) {
+        // 负数编号为索引分区
+        if (block_id >= 0 && static_cast<size_t>(block_id) < block_number) {
+            size_t block_size;
+            BlockMeta meta_entry = get_block_meta(block_id, block_size, CachePriority::BYPASS);
+            // 短分隔符格式没有下界 以前一数据块的上界代替
+            if (meta_entry.fkey.empty() && block_id > 0) {
+                meta_entry.fkey = get_block_meta(block_id - 1, block_size, CachePriority::BYPASS).lkey;
+            }
+            ranges.emplace_back(meta_entry.fkey, meta_entry.lkey);
+        }
+    }
+    return ranges;
 }
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
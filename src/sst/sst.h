@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -11,32 +12,124 @@
 #include "block/block.h"
 #include "block/block_cache.h"
 #include "block/block_meta.h"
-#include "utils/bloom_filter.h"
+#include "block/learned_index.h"
+#include "block/meta_cache.h"
+#include "sst/blob_file.h"
+#include "sst/sst_properties.h"
+#include "utils/compression.h"
+#include "utils/filter.h"
+#include "utils/prefix_extractor.h"
+#include "utils/range_filter.h"
 #include "utils/files.h"
 
 namespace LSMT {
 /**
- * --------------------------------------------------------------------------------------------------------------------------------------------
- * |           Block Section           |          Meta Section          | Bloom Filter |                   Extra Information                  |
- * --------------------------------------------------------------------------------------------------------------------------------------------
- * | Block 1 | Block 2 | ... | Block N | Number | Meta 1 | ... | Meta N |              | Meta Offset | Bloom Offset | Min TRX_ID | MAX TRX_ID |
- * --------------------------------------------------------------------------------------------------------------------------------------------
+ * ---------------------------------------------------------------------------------------------------------------------
+ * |           Block Section           |          Meta Section          | Filter Section | Properties Section |  Footer  |
+ * ---------------------------------------------------------------------------------------------------------------------
+ * | Block 1 | Block 2 | ... | Block N | Number | Meta 1 | ... | Meta N |                |                    |   56B    |
+ * ---------------------------------------------------------------------------------------------------------------------
+ *
+ * -----------------------------------------------------------------------------------------------------------------------
+ * |                                                       Footer                                                        |
+ * -----------------------------------------------------------------------------------------------------------------------
+ * | Properties Offset(8B) | Meta Offset(8B) | Filter Offset(8B) | Min TRX_ID(8B) | Max TRX_ID(8B) | Features(4B) | ... |
+ * -----------------------------------------------------------------------------------------------------------------------
+ * | Version(4B) | Magic(8B) |
+ * -------------------------
+ * 版本1为旧格式 没有Magic 文件末尾依次为Meta Offset(4B) Bloom Offset(4B) Min TRX_ID(8B) Max TRX_ID(8B)
+ * 版本1的数据块没有压缩类型字节 版本2起每个数据块末尾都带有压缩类型字节
+ * 版本3起数据块和Meta Section使用变长长度和4/8字节偏移 不再限制单个key/value和文件大小
+ * 版本4起Footer开头增加Properties Offset 过滤器段之后为统计信息段 见sst/sst_properties.h 之前的版本Footer为48B
+ *
+ * ------------------------------------
+ * |             Block N              |
+ * ------------------------------------
+ * | Block Data | Compression Type(1B) |
+ * ------------------------------------
+ * Block Data为Block::encode的结果 压缩时为utils/compression.h中的压缩格式 解压后再放入块缓存
+ * 数据块中带有BlobIndex时Features置位BLOB_INDEX 对各Blob文件的引用记录在统计信息段 版本4之前的文件打开时扫描数据块统计
+ *
+ * 分区索引: Features置位PARTITIONED_INDEX时Block Section之后为各索引分区 Meta Section只保存顶层索引
+ * --------------------------------------------------------------------------------------------------
+ * |           Block Section           |        Index Section        | Meta Section |      ...      |
+ * --------------------------------------------------------------------------------------------------
+ * | Block 1 | Block 2 | ... | Block N | Partition 1 | ... | Partition M | Top Level Index |        |
+ * --------------------------------------------------------------------------------------------------
+ * 索引分区以负数编号-1 - partition_id放入块缓存 查找时先在顶层索引上二分 再在一个分区内二分
+ * Features置位SHORT_SEPARATOR时索引中每个数据块只保存到下一数据块之间的最短分隔符 格式见block/block_meta.h
+ * 此时查找定位到第一个分隔符不小于key的数据块 落在相邻数据块之间的key需要读取数据块才能确定不存在
+ *
+ * 学习索引: Features置位LEARNED_INDEX时Meta Section末尾附加学习索引 格式见block/learned_index.h
+ * ---------------------------------------------------------------
+ * |                         Meta Section                        |
+ * ---------------------------------------------------------------
+ * | Block Meta | Learned Index | Learned Index Size(4B) |
+ * ---------------------------------------------------------------
+ * 只用于扁平索引 查找时先由模型预测数据块编号 只在误差窗口内二分
  **/
 
 class SSTBuilder;
 class SSTIterator;
 
+enum SSTFeature : uint32_t {
+    SST_FEATURE_PREFIX_COMPRESSION = 1 << 0,  // 数据块使用前缀压缩
+    SST_FEATURE_HASH_INDEX         = 1 << 1,  // 数据块带有哈希索引
+    SST_FEATURE_BLOCK_COMPRESSION  = 1 << 2,  // 至少有一个数据块被压缩
+    SST_FEATURE_BLOB_INDEX         = 1 << 3,  // 至少有一个值保存在Blob文件中
+    SST_FEATURE_TRX_ID_DELTA       = 1 << 4,  // 数据块中的事务id按差值变长编码
+    SST_FEATURE_PARTITIONED_INDEX  = 1 << 5,  // 索引拆分为按需读取的分区
+    SST_FEATURE_SHORT_SEPARATOR    = 1 << 6,  // 索引只保存数据块之间的最短分隔符
+    SST_FEATURE_LEARNED_INDEX      = 1 << 7,  // Meta Section末尾附加分段线性的学习索引
+};
+
+struct SSTFooter {
+    static constexpr uint64_t MAGIC = 0x4c534d5453535446;  // "LSMTSSTF"
+    static constexpr uint32_t CURRENT_VERSION = 4;
+    static constexpr size_t SIZE = 5 * sizeof(uint64_t) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+    static constexpr size_t V3_SIZE = SIZE - sizeof(uint64_t);
+    static constexpr size_t LEGACY_SIZE = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+    uint64_t properties_offset = 0;  // 版本4之前没有统计信息段 为0
+    uint64_t meta_section_offset = 0;
+    uint64_t filter_section_offset = 0;
+    uint64_t min_trx_id = 0;
+    uint64_t max_trx_id = 0;
+    uint32_t features = 0;
+    uint32_t version = CURRENT_VERSION;
+    size_t footer_size = SIZE;  // 不编码 旧格式为V3_SIZE或LEGACY_SIZE
+
+    // 过滤器段之后第一个字节的位置
+    uint64_t get_filter_section_end(size_t file_size) const;
+
+    std::vector<uint8_t> encode() const;
+
+    // 根据文件末尾的Magic和版本号解析 没有Magic的文件按版本1读取
+    static SSTFooter read(FileObj &file_obj);
+};
+
 class SST : public std::enable_shared_from_this<SST> {
     friend class SSTBuilder;
 
 public:
-    static std::shared_ptr<SST> open(size_t sst_id, FileObj file_obj, std::shared_ptr<BlockCache> block_cache);
+    static std::shared_ptr<SST> open(size_t sst_id, FileObj file_obj, std::shared_ptr<BaseCache> block_cache);
 
     void remove();
 
+    // 将索引和过滤器交由高优先级缓存池管理 pinned为true时常驻内存且不参与淘汰
+    void set_meta_cache(std::shared_ptr<MetaCache> meta_cache, bool pinned);
+
+    void set_blob_storage(std::shared_ptr<BlobStorage> blob_storage);
+
+    // 每个被引用的Blob文件及引用的字节数
+    const std::map<uint64_t, uint64_t> &get_blob_refs() const;
+
+    // 通过BlobIndex读取保存在Blob文件中的值
+    std::string get_blob(std::string_view key, std::string_view blob_index);
+
     int64_t get_block_id(const std::string &key);
     
-    std::shared_ptr<Block> get_block(size_t block_id);
+    std::shared_ptr<Block> get_block(size_t block_id, CachePriority priority = CachePriority::NORMAL);
 
     SSTIterator get(const std::string &key, uint64_t trx_id);
 
@@ -50,7 +143,7 @@ public:
 
     size_t get_block_number() const;
 
-    SSTIterator begin(uint64_t trx_id);
+    SSTIterator begin(uint64_t trx_id, CachePriority priority = CachePriority::NORMAL, bool resolve_blob = true);
     
     SSTIterator end();
 
@@ -59,18 +152,50 @@ public:
 
     std::pair<uint64_t, uint64_t> get_trx_id_range() const;
 
+    const SSTFooter &get_footer() const;
+
+    // 版本4之前的文件没有统计信息 返回nullptr
+    const SSTProperties *get_properties() const;
+
+    // 判断SST是否可能包含以preffix开头的键 返回false时可以跳过该SST
+    bool may_contain_preffix(const std::string &preffix, const std::shared_ptr<PrefixExtractor> &extractor);
+
+    // 判断SST是否可能包含位于[lower, upper]之间的键 返回false时可以跳过该SST
+    bool may_contain_range(const std::string &lower, const std::string &upper);
+
+    // 返回当前仍在块缓存中的数据块的键范围 用于合并后预热新SST的热点数据块
+    std::vector<std::pair<std::string, std::string>> get_cached_ranges();
+
+private:
+    std::shared_ptr<SSTMeta> get_meta();
+
+    std::shared_ptr<SSTMeta> load_meta();
+
+    void load_blob_refs();
+
+    bool is_index_partitioned() const;
+
+    bool has_short_separator() const;
+
+    // 读取索引分区 优先从块缓存中获取
+    std::shared_ptr<Block> get_index_partition(size_t partition_id, CachePriority priority);
+
+    // 获取数据块的索引项 block_size为数据块在文件中的字节数
+    BlockMeta get_block_meta(size_t block_id, size_t &block_size, CachePriority priority = CachePriority::NORMAL);
+
 private:
     size_t sst_id;
     FileObj file_obj;
-    std::vector<BlockMeta> meta_entries;
-    uint32_t meta_section_offset;
-    uint32_t bloom_filter_offset;
+    std::shared_ptr<SSTMeta> meta;  // 未交由缓存管理或被固定时常驻 否则为空
+    std::shared_ptr<MetaCache> meta_cache;
+    size_t block_number;
+    SSTFooter footer;
     std::string fkey;
     std::string lkey;
-    std::shared_ptr<BloomFilter> filter;
-    std::shared_ptr<BlockCache> block_cache;
-    uint64_t min_trx_id;
-    uint64_t max_trx_id;
+    std::shared_ptr<BaseCache> block_cache;
+    std::shared_ptr<BlobStorage> blob_storage;
+    std::map<uint64_t, uint64_t> blob_refs;
+    std::unique_ptr<SSTProperties> properties;
 };
 
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
@@ -1,36 +1,96 @@
 #include "sst.h"
 #include "sst_builder.h"
 #include "config/config.h"
+#include "utils/hash.h"
 
 namespace LSMT {
 
-SSTBuilder::SSTBuilder(size_t block_size, bool has_bloom) : block(block_size) {
-    if (has_bloom) {
-        bloom_filter = std::make_shared<BloomFilter>(
-            TomlConfig::get_instance().get_bloom_filter_expected_elements(),
-            TomlConfig::get_instance().get_bloom_filter_false_positive_rate()
-        );
-    }
+SSTBuilder::SSTBuilder(size_t block_size, bool has_bloom)
+: block(block_size, std::max(TomlConfig::get_instance().get_lsm_block_restart_interval(), 0)) {
+    has_filter = has_bloom;
+    bits_per_key = TomlConfig::get_instance().get_bloom_filter_bits_per_key();
+    filter_type = FilterType::BLOCKED_BLOOM;
+    prefix_extractor = PrefixExtractor::create(TomlConfig::get_instance().get_bloom_filter_prefix_extractor());
+    set_range_filter(TomlConfig::get_instance().get_bloom_filter_range_filter());
+    compression = CompressionType::NONE;
+    compression_ratio = TomlConfig::get_instance().get_lsm_block_compression_ratio();
     block_size = block_size;
+    index_partition_size = std::max(TomlConfig::get_instance().get_lsm_index_partition_size(), 0);
+    short_separator = TomlConfig::get_instance().get_lsm_index_short_separator();
+    learned_index_error = std::max(TomlConfig::get_instance().get_lsm_index_learned_error(), 0);
     min_trx_id = UINT64_MAX;
     max_trx_id = 0;
+    features = 0;
+    prepopulate = CachePrepopulate::NONE;
+    min_blob_size = 0;
+    block.set_trx_id_delta(TomlConfig::get_instance().get_lsm_block_trx_id_delta());
 }
 
 void SSTBuilder::add(const std::string &key, const std::string &val, uint64_t trx_id) {
-    if (bloom_filter != nullptr) {
-        bloom_filter->add(key);
+    // 较大的值写入Blob文件 SST中只保存BlobIndex 空值为删除标记 不会被分离
+    if (blob_storage != nullptr && min_blob_size > 0 && val.size() >= min_blob_size) {
+        if (blob_builder == nullptr) {
+            blob_builder = std::make_unique<BlobFileBuilder>(blob_storage->new_file_id());
+        }
+        BlobIndex index = blob_builder->add(key, val);
+        blob_refs[index.file_id] += index.size;
+        add_entry(key, index.encode(), trx_id, true);
+    } else {
+        add_entry(key, val, trx_id, false);
+    }
+}
+
+void SSTBuilder::add_blob_index(const std::string &key, const std::string &blob_index, uint64_t trx_id) {
+    if (blob_storage == nullptr) {
+        throw std::runtime_error("Blob Storage Is Not Set");
+    }
+    BlobIndex index = BlobIndex::decode(blob_index);
+    if (blob_storage->need_relocate(index.file_id)) {
+        add(key, blob_storage->get(index, key), trx_id);
+        return;
+    }
+    blob_refs[index.file_id] += index.size;
+    add_entry(key, blob_index, trx_id, true);
+}
+
+void SSTBuilder::add_entry(const std::string &key, const std::string &val, uint64_t trx_id, bool is_blob_index) {
+    // 同一个键的多个版本相邻出现 只记录一次哈希
+    if (has_filter && (key_hashes.empty() || key != lkey)) {
+        key_hashes.push_back(murmur_hash64(key));
+        // 有序输入中前缀相同的键必然相邻 与上一个前缀比较即可去重
+        if (prefix_extractor != nullptr && prefix_extractor->in_domain(key)) {
+            std::string prefix = prefix_extractor->transform(key);
+            if (prefix_hashes.empty() || prefix != last_prefix) {
+                prefix_hashes.push_back(murmur_hash64(prefix));
+                last_prefix = std::move(prefix);
+            }
+        }
+        if (range_filter != nullptr) {
+            range_filter->add(key);
+        }
     }
     min_trx_id = std::min(min_trx_id, trx_id);
     max_trx_id = std::max(max_trx_id, trx_id);
 
-    bool force_write = (key == lkey);
+    if (properties.entry_number == 0 || key != lkey) {
+        ++properties.key_number;
+    }
+    ++properties.entry_number;
+    if (val.empty() && !is_blob_index) {
+        ++properties.tombstone_number;
+    }
+    properties.raw_key_size += key.size();
+    properties.raw_value_size += val.size();
+
+    // 空数据块总是写入 超过容量的大元素单独占用一个数据块
+    bool force_write = (key == lkey) || block.is_empty();
 
-    if (block.add_entry(key, val, trx_id, force_write) == true) {
+    if (block.add_entry(key, val, trx_id, force_write, is_blob_index) == true) {
         fkey = fkey.empty() ? key : fkey;
         lkey = key;
     } else {
         finish_block();
-        block.add_entry(key, val, trx_id, false);
+        block.add_entry(key, val, trx_id, true, is_blob_index);
         fkey = key;
         lkey = key;
     }
@@ -47,13 +107,168 @@ size_t SSTBuilder::real_size() const {
 void SSTBuilder::finish_block() {
     auto old_block = std::move(this->block);
     auto encoded_data = old_block.encode();
+    properties.add_block(old_block.get_entry_number());
+    properties.raw_data_size += encoded_data.size();
+
+    // 压缩收益不足的数据块按原样保存 读取时省去解压开销
+    CompressionType type = compression;
+    std::vector<uint8_t> compressed_data;
+    if (compress(type, encoded_data.data(), encoded_data.size(), compression_ratio, compressed_data)) {
+        encoded_data = std::move(compressed_data);
+    } else {
+        type = CompressionType::NONE;
+    }
+    // 压缩类型字节只出现在版本2及以上的文件中 由build写入的Footer版本标记
+    encoded_data.push_back(static_cast<uint8_t>(type));
+
+    // 记录SST使用的格式特性 写入Footer
+    if (old_block.is_prefix_compressed()) {
+        features |= SST_FEATURE_PREFIX_COMPRESSION;
+    }
+    if (old_block.has_hash_index()) {
+        features |= SST_FEATURE_HASH_INDEX;
+    }
+    if (old_block.has_trx_id_delta()) {
+        features |= SST_FEATURE_TRX_ID_DELTA;
+    }
+    if (type != CompressionType::NONE) {
+        features |= SST_FEATURE_BLOCK_COMPRESSION;
+    }
+    if (!blob_refs.empty()) {
+        features |= SST_FEATURE_BLOB_INDEX;
+    }
 
     meta_entries.emplace_back(data.size(), fkey, lkey);
 
     data.insert(data.end(), encoded_data.begin(), encoded_data.end());
+
+    // 在完成数据块时决定是否预热 只保留将要插入缓存的数据块 数量不超过缓存能容纳的上限
+    if (prepopulate != CachePrepopulate::NONE && prepopulate_cache != nullptr) {
+        size_t limit = prepopulate == CachePrepopulate::ALL
+            ? prepopulate_cache->get_capacity() - std::min(prepopulate_cache->get_usage(), prepopulate_cache->get_capacity())
+            : prepopulate_cache->get_capacity();
+        if (blocks.size() < limit && (prepopulate == CachePrepopulate::ALL || is_hot(fkey, lkey))) {
+            blocks.emplace_back(meta_entries.size() - 1, std::make_shared<Block>(std::move(old_block)));
+        }
+    }
+}
+
+void SSTBuilder::set_bits_per_key(double bits_per_key) {
+    this->bits_per_key = bits_per_key;
+}
+
+void SSTBuilder::set_filter_type(FilterType filter_type) {
+    this->filter_type = filter_type;
+}
+
+void SSTBuilder::set_prefix_extractor(std::shared_ptr<PrefixExtractor> prefix_extractor) {
+    this->prefix_extractor = prefix_extractor;
+}
+
+void SSTBuilder::set_range_filter(bool enable) {
+    range_filter = enable && has_filter ? std::make_shared<RangeFilter>() : nullptr;
+}
+
+void SSTBuilder::set_hash_index(bool enable) {
+    block.set_hash_index(enable);
+}
+
+void SSTBuilder::set_index_partition_size(size_t index_partition_size) {
+    this->index_partition_size = index_partition_size;
+}
+
+void SSTBuilder::set_index_short_separator(bool enable) {
+    short_separator = enable;
 }
 
-std::shared_ptr<SST> SSTBuilder::build(size_t sst_id, const std::string &path, std::shared_ptr<BlockCache> block_cache) {
+void SSTBuilder::set_learned_index_error(size_t learned_index_error) {
+    this->learned_index_error = learned_index_error;
+}
+
+void SSTBuilder::set_compression(CompressionType compression) {
+    this->compression = compression;
+}
+
+void SSTBuilder::set_blob_storage(std::shared_ptr<BlobStorage> blob_storage, size_t min_blob_size) {
+    this->blob_storage = blob_storage;
+    this->min_blob_size = min_blob_size;
+    // 没有Blob文件时不会出现BlobIndex 保持数据块为不带标记的格式
+    block.set_blob_index(blob_storage != nullptr && (min_blob_size > 0 || blob_storage->get_file_number() > 0));
+}
+
+void SSTBuilder::set_prepopulate(CachePrepopulate mode, std::shared_ptr<BaseCache> block_cache,
+        std::vector<std::pair<std::string, std::string>> hot_ranges) {
+    prepopulate = mode;
+    prepopulate_cache = block_cache;
+
+    // 合并重叠的键范围 便于按数据块键范围二分查找
+    std::sort(hot_ranges.begin(), hot_ranges.end());
+    this->hot_ranges.clear();
+    for (auto &range : hot_ranges) {
+        if (!this->hot_ranges.empty() && range.first <= this->hot_ranges.back().second) {
+            this->hot_ranges.back().second = std::max(this->hot_ranges.back().second, range.second);
+        } else {
+            this->hot_ranges.push_back(std::move(range));
+        }
+    }
+}
+
+bool SSTBuilder::is_hot(const std::string &fkey, const std::string &lkey) const {
+    // 找到第一个结束键不小于fkey的热点范围 若其起始键不大于lkey则两者重叠
+    auto it = std::lower_bound(hot_ranges.begin(), hot_ranges.end(), fkey,
+        [](const std::pair<std::string, std::string> &range, const std::string &key) { return range.second < key; });
+    return it != hot_ranges.end() && it->first <= lkey;
+}
+
+std::vector<IndexPartition> SSTBuilder::build_index_partitions(size_t base_offset,
+        std::vector<uint8_t> &partition_data) const {
+    std::vector<IndexPartition> partitions;
+    Block partition(index_partition_size, std::max(TomlConfig::get_instance().get_lsm_block_restart_interval(), 0));
+    partition.set_trx_id_delta(true);
+
+    // 短分隔符格式中每个数据块以separator作为分区内的key 最后一个数据块保留尾key
+    auto get_separator = [this](size_t block_id) {
+        return block_id + 1 < meta_entries.size()
+            ? BlockMeta::shortest_separator(meta_entries[block_id].lkey, meta_entries[block_id + 1].fkey)
+            : meta_entries[block_id].lkey;
+    };
+
+    // 完成当前分区 记录其位置和键范围
+    auto finish_partition = [&](size_t last_block) {
+        IndexPartition index_partition;
+        index_partition.offset = base_offset + partition_data.size();
+        index_partition.block_number = partition.get_entry_number();
+        index_partition.first_block = last_block + 1 - index_partition.block_number;
+        if (!short_separator) {
+            index_partition.fkey = meta_entries[index_partition.first_block].fkey;
+            index_partition.lkey = meta_entries[last_block].lkey;
+        } else {
+            index_partition.fkey = index_partition.first_block == 0 ? meta_entries.front().fkey : "";
+            index_partition.lkey = get_separator(last_block);
+        }
+        auto encoded = partition.encode();
+        index_partition.size = encoded.size();
+        partition_data.insert(partition_data.end(), encoded.begin(), encoded.end());
+        partitions.push_back(std::move(index_partition));
+    };
+
+    for (size_t i = 0; i < meta_entries.size(); ++i) {
+        size_t size = (i + 1 < meta_entries.size() ? meta_entries[i + 1].offset : data.size()) - meta_entries[i].offset;
+        std::string key = short_separator ? get_separator(i) : meta_entries[i].fkey;
+        std::string handle = BlockMeta::encode_handle(meta_entries[i].offset, size,
+            short_separator ? "" : meta_entries[i].lkey);
+        if (!partition.add_entry(key, handle, 0, partition.is_empty())) {
+            finish_partition(i - 1);
+            partition = Block(index_partition_size, std::max(TomlConfig::get_instance().get_lsm_block_restart_interval(), 0));
+            partition.set_trx_id_delta(true);
+            partition.add_entry(key, handle, 0, true);
+        }
+    }
+    finish_partition(meta_entries.size() - 1);
+    return partitions;
+}
+
+std::shared_ptr<SST> SSTBuilder::build(size_t sst_id, const std::string &path, std::shared_ptr<BaseCache> block_cache) {
     if (block.is_empty() == false) {
         finish_block();
     }
@@ -62,19 +277,77 @@ std::shared_ptr<SST> SSTBuilder::build(size_t sst_id, const std::string &path, s
         throw std::runtime_error("Cannot Build an Empty SST");
     }
 
-    // 获取Meta Section编码和偏移量
+    // 先写入Blob文件 保证SST可见时其引用的值已经落盘
+    if (blob_builder != nullptr && !blob_builder->is_empty()) {
+        blob_storage->add_file(blob_builder->build(blob_storage->get_blob_path(blob_builder->get_file_id())));
+    }
+
+    // 获取Meta Section编码和偏移量 索引过大时拆分为分区 Meta Section只保存顶层索引
     std::vector<uint8_t> meta_section_data;
-    BlockMeta::encode_meta(meta_entries, meta_section_data);
-    uint32_t meta_section_offset = data.size();
+    std::vector<uint8_t> partition_data;
+    std::vector<IndexPartition> partitions;
+    BlockMeta::encode_meta(meta_entries, meta_section_data, short_separator);
+    if (index_partition_size > 0 && meta_section_data.size() > index_partition_size) {
+        partitions = build_index_partitions(data.size(), partition_data);
+        IndexPartition::encode_partitions(partitions, meta_section_data);
+        features |= SST_FEATURE_PARTITIONED_INDEX;
+    }
+    if (short_separator) {
+        features |= SST_FEATURE_SHORT_SEPARATOR;
+    }
+
+    // 扁平索引按读取时的形式保存在内存中 短分隔符格式下每个数据块也只保存一个边界
+    std::vector<BlockMeta> index_entries;
+    if (partitions.empty() && short_separator) {
+        BlockMeta::decode_meta(meta_section_data, index_entries);
+    } else if (partitions.empty()) {
+        index_entries = meta_entries;
+    }
+
+    // 学习索引对读取时的上界拟合 附加在Meta Section末尾
+    std::shared_ptr<LearnedIndex> learned_index;
+    if (partitions.empty() && learned_index_error > 0) {
+        learned_index = LearnedIndex::build(index_entries, learned_index_error);
+    }
+    if (learned_index != nullptr) {
+        std::vector<uint8_t> learned_data = learned_index->encode();
+        uint32_t learned_size = learned_data.size();
+        learned_data.resize(learned_data.size() + sizeof(uint32_t));
+        memcpy(learned_data.data() + learned_size, &learned_size, sizeof(uint32_t));
+        meta_section_data.insert(meta_section_data.end(), learned_data.begin(), learned_data.end());
+        features |= SST_FEATURE_LEARNED_INDEX;
+    }
+
+    SSTFooter footer;
+    footer.meta_section_offset = data.size() + partition_data.size();
 
     // 获取Bloom Filter编码和偏移量
+    FilterSection filters;
     std::vector<uint8_t> bloom_filter_data;
-    if (bloom_filter != nullptr) {
-        bloom_filter_data = bloom_filter->encode();
+    if (has_filter && bits_per_key > 0) {
+        filters.key_filter = BaseFilter::create(filter_type, key_hashes, bits_per_key);
+        if (prefix_extractor != nullptr) {
+            filters.prefix_filter = BaseFilter::create(filter_type, prefix_hashes, bits_per_key);
+            filters.prefix_extractor = prefix_extractor->get_name();
+        }
     }
-    uint32_t bloom_filter_offset = data.size() + meta_section_data.size();
+    filters.range_filter = range_filter;
+    bloom_filter_data = filters.encode();
+    footer.filter_section_offset = footer.meta_section_offset + meta_section_data.size();
+    footer.min_trx_id = min_trx_id;
+    footer.max_trx_id = max_trx_id;
+    footer.features = features;
+
+    // 获取统计信息段编码和偏移量
+    properties.data_size = data.size();
+    properties.blob_refs = blob_refs;
+    properties.creation_time = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::vector<uint8_t> properties_data = properties.encode();
+    footer.properties_offset = footer.filter_section_offset + bloom_filter_data.size();
+    std::vector<uint8_t> footer_data = footer.encode();
     
-    // 依次写入DataSection MetaSection BloomFilter ExtraInformation
+    // 依次写入DataSection IndexSection MetaSection BloomFilter Properties Footer
     size_t write_offset = 0;
     FileObj file_obj = FileObj::create_and_write(path, {});
     if (!data.empty() && !file_obj.write(write_offset, data)) {
@@ -82,6 +355,11 @@ std::shared_ptr<SST> SSTBuilder::build(size_t sst_id, const std::string &path, s
     }
     write_offset += data.size();
 
+    if (!partition_data.empty() && !file_obj.write(write_offset, partition_data)) {
+        throw std::runtime_error("Failed To Write Index Section in " + path);
+    }
+    write_offset += partition_data.size();
+
     if (!meta_section_data.empty() && !file_obj.write(write_offset, meta_section_data)) {
         throw std::runtime_error("Failed To Write Meta Section in " + path);
     }
@@ -92,25 +370,15 @@ std::shared_ptr<SST> SSTBuilder::build(size_t sst_id, const std::string &path, s
     }
     write_offset += bloom_filter_data.size();
 
-    if (!file_obj.write_uint32(write_offset, meta_section_offset)) {
-        throw std::runtime_error("Failed To Write Meta Offset in " + path);
-    }
-    write_offset += sizeof(uint32_t);
-
-    if (!file_obj.write_uint32(write_offset, bloom_filter_offset)) {
-        throw std::runtime_error("Failed To Write Bloom Offset in " + path);
+    if (!file_obj.write(write_offset, properties_data)) {
+        throw std::runtime_error("Failed To Write Properties in " + path);
     }
-    write_offset += sizeof(uint32_t);
+    write_offset += properties_data.size();
 
-    if (!file_obj.write_uint64(write_offset, min_trx_id)) {
-        throw std::runtime_error("Failed To Write Min Transaction Id in " + path);
+    if (!file_obj.write(write_offset, footer_data)) {
+        throw std::runtime_error("Failed To Write Footer in " + path);
     }
-    write_offset += sizeof(uint64_t);
-
-    if (!file_obj.write_uint64(write_offset, max_trx_id)) {
-        throw std::runtime_error("Failed To Write Max Transaction Id in " + path);
-    }
-    write_offset += sizeof(uint64_t);
+    write_offset += footer_data.size();
 
     if (!file_obj.sync()) {
         throw std::runtime_error("Failed To Sync File " + path);
@@ -120,15 +388,36 @@ std::shared_ptr<SST> SSTBuilder::build(size_t sst_id, const std::string &path, s
 
     result->sst_id = sst_id;
     result->file_obj = std::move(file_obj);
-    result->meta_entries = meta_entries;
-    result->bloom_filter_offset = bloom_filter_offset;
-    result->meta_section_offset = meta_section_offset;
+    result->meta = std::make_shared<SSTMeta>();
+    result->meta->meta_entries = std::move(index_entries);
+    result->meta->partitions = partitions;
+    result->meta->learned_index = learned_index;
+    result->meta->filters = filters;
+    result->meta->charge = meta_section_data.size() + bloom_filter_data.size();
+    result->block_number = meta_entries.size();
+    result->footer = footer;
     result->fkey = meta_entries.front().fkey;
     result->lkey = meta_entries.back().lkey;
-    result->filter = bloom_filter;
     result->block_cache = block_cache;
-    result->min_trx_id = min_trx_id;
-    result->max_trx_id = max_trx_id;
+    result->blob_storage = blob_storage;
+    result->blob_refs = blob_refs;
+    result->properties = std::make_unique<SSTProperties>(properties);
+
+    // 缓存预热: ALL只在缓存仍有空闲容量时以LOW优先级插入 缓存已满即停止 避免淘汰已有数据块
+    // HOT将覆盖原热点范围的数据块以WARM优先级插入 替换输入SST中即将失效的热点数据块
+    if (block_cache != nullptr && prepopulate != CachePrepopulate::NONE) {
+        for (auto &[block_id, prepopulate_block] : blocks) {
+            if (prepopulate == CachePrepopulate::ALL) {
+                if (block_cache->get_usage() >= block_cache->get_capacity()) {
+                    break;
+                }
+                block_cache->put(sst_id, block_id, prepopulate_block, CachePriority::LOW);
+            } else {
+                block_cache->put(sst_id, block_id, prepopulate_block, CachePriority::WARM);
+            }
+        }
+        blocks.clear();
+    }
 
     return result;
 }
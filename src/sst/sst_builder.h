@@ -1,15 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "block/block.h"
 #include "block/block_cache.h"
 #include "block/block_meta.h"
-#include "utils/bloom_filter.h"
+#include "sst/blob_file.h"
+#include "sst/sst_properties.h"
+#include "utils/compression.h"
+#include "utils/filter.h"
+#include "utils/prefix_extractor.h"
+#include "utils/range_filter.h"
 #include "utils/files.h"
 
 namespace LSMT {
@@ -21,13 +30,56 @@ public:
 
     void add(const std::string &key, const std::string &val, uint64_t trx_id);
 
+    // 写入合并时读到的BlobIndex 所在文件垃圾比例过高时读出值重新写入新的Blob文件
+    void add_blob_index(const std::string &key, const std::string &blob_index, uint64_t trx_id);
+
     size_t estimated_size() const;
 
     size_t real_size() const;
 
     void finish_block();
 
-    std::shared_ptr<SST> build(size_t sst_id, const std::string &path, std::shared_ptr<BlockCache> block_cache);
+    void set_bits_per_key(double bits_per_key);
+
+    void set_filter_type(FilterType filter_type);
+
+    void set_prefix_extractor(std::shared_ptr<PrefixExtractor> prefix_extractor);
+
+    // 需要在加入第一个键之前设置
+    void set_range_filter(bool enable);
+
+    // 需要在加入第一个键之前设置 为数据块生成哈希索引
+    void set_hash_index(bool enable);
+
+    // 系统没有对应压缩库时回退到LZ4
+    void set_compression(CompressionType compression);
+
+    // 索引编码后超过该字节数时拆分为索引分区 0表示不拆分
+    void set_index_partition_size(size_t index_partition_size);
+
+    // 索引中每个数据块只保存与下一数据块之间的最短分隔符
+    void set_index_short_separator(bool enable);
+
+    // 大于0时为未拆分的索引附加学习索引 按数据块编号计的目标误差 拟合效果差时不生成
+    void set_learned_index_error(size_t learned_index_error);
+
+    // 需要在加入第一个键之前设置 不小于min_blob_size的值写入Blob文件 SST中只保存BlobIndex
+    void set_blob_storage(std::shared_ptr<BlobStorage> blob_storage, size_t min_blob_size);
+
+    // 设置构建完成后的缓存预热策略 block_cache应与build传入的块缓存相同 用于在构建期间限制保留的数据块数量
+    // ALL只使用缓存的空闲容量 不淘汰已有数据块 HOT中hot_ranges为输入SST中已缓存数据块的键范围
+    void set_prepopulate(CachePrepopulate mode, std::shared_ptr<BaseCache> block_cache,
+        std::vector<std::pair<std::string, std::string>> hot_ranges = {});
+
+    std::shared_ptr<SST> build(size_t sst_id, const std::string &path, std::shared_ptr<BaseCache> block_cache);
+
+private:
+    void add_entry(const std::string &key, const std::string &val, uint64_t trx_id, bool is_blob_index);
+
+    bool is_hot(const std::string &fkey, const std::string &lkey) const;
+
+    // 将各数据块的索引项按index_partition_size拆分为分区 编码写入partition_data 分区偏移从base_offset开始
+    std::vector<IndexPartition> build_index_partitions(size_t base_offset, std::vector<uint8_t> &partition_data) const;
 
 private:
     Block block;
@@ -35,9 +87,31 @@ private:
     std::string lkey;
     std::vector<BlockMeta> meta_entries;
     std::vector<uint8_t> data;
-    std::shared_ptr<BloomFilter> bloom_filter;
+    std::vector<uint64_t> key_hashes;  // 去重后所有键的哈希 构建时按实际键数量生成过滤器
+    bool has_filter;
+    double bits_per_key;
+    FilterType filter_type;
+    std::shared_ptr<PrefixExtractor> prefix_extractor;
+    std::vector<uint64_t> prefix_hashes;  // 去重后所有键前缀的哈希
+    std::string last_prefix;
+    std::shared_ptr<RangeFilter> range_filter;  // 键按序加入 构建时编码
+    CompressionType compression;
+    double compression_ratio;  // 压缩后不小于原大小该比例的数据块不压缩
     size_t block_size;
+    size_t index_partition_size;
+    bool short_separator;
+    size_t learned_index_error;
     uint64_t min_trx_id;
     uint64_t max_trx_id;
+    uint32_t features;  // 已完成数据块使用的SSTFeature
+    CachePrepopulate prepopulate;
+    std::vector<std::pair<std::string, std::string>> hot_ranges;  // 按起始键排序且互不重叠
+    std::shared_ptr<BaseCache> prepopulate_cache;
+    std::vector<std::pair<int, std::shared_ptr<Block>>> blocks;   // 预热时保留将要插入缓存的数据块及其编号
+    std::shared_ptr<BlobStorage> blob_storage;
+    size_t min_blob_size;
+    std::unique_ptr<BlobFileBuilder> blob_builder;  // 第一次写入大值时创建
+    std::map<uint64_t, uint64_t> blob_refs;          // 每个被引用的Blob文件及引用的字节数
+    SSTProperties properties;                        // 构建时统计 写入统计信息段
 };
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
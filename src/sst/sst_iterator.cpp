@@ -2,16 +2,16 @@
 #include "sst_iterator.h"
 
 namespace LSMT {
-SSTIterator::SSTIterator(std::shared_ptr<SST> sst, uint64_t trx_id) 
-: sst(sst), block_id(0), block_it(nullptr), max_trx_id(trx_id) {
+SSTIterator::SSTIterator(std::shared_ptr<SST> sst, uint64_t trx_id, CachePriority priority, bool resolve_blob)
+: sst(sst), block_id(0), block_it(nullptr), max_trx_id(trx_id), priority(priority), resolve_blob(resolve_blob) {
     if (sst == nullptr || sst->get_block_number() == 0) {
         return;
     }
-    block_it = std::make_shared<BlockIterator>(sst->get_block(block_id), 0, trx_id);
+    block_it = std::make_shared<BlockIterator>(sst->get_block(block_id, priority), 0, trx_id);
 }
 
 SSTIterator::SSTIterator(std::shared_ptr<SST> sst, const std::string &key, uint64_t trx_id)
-: sst(sst), block_id(0), block_it(nullptr), max_trx_id(trx_id) {
+: sst(sst), block_id(0), block_it(nullptr), max_trx_id(trx_id), priority(CachePriority::NORMAL), resolve_blob(true) {
     if (sst == nullptr || sst->get_block_number() == 0) {
         return;
     }
@@ -52,7 +52,7 @@ SSTIterator::BaseIterator &SSTIterator::operator++() {
     if (block_it->is_end()) {
         block_id++;
         if (block_id < sst->get_block_number()) {
-            block_it = std::make_shared<BlockIterator>(sst->get_block(block_id), 0, max_trx_id);
+            block_it = std::make_shared<BlockIterator>(sst->get_block(block_id, priority), 0, max_trx_id);
         } else {
             block_it = nullptr;
         }
@@ -97,27 +97,35 @@ bool SSTIterator::is_vld() const {
     return block_it && !block_it->is_end() && block_id < sst->get_block_number();
 }
 
+bool SSTIterator::is_blob_index() const {
+    return !resolve_blob && block_it != nullptr && !block_it->is_end() && block_it->is_blob_index();
+}
+
 void SSTIterator::update_current() const {
     if (block_it != nullptr && !block_it->is_end()) {
         cached_value = *(*block_it);
+        if (resolve_blob && block_it->is_blob_index()) {
+            cached_value->second = sst->get_blob(cached_value->first, cached_value->second);
+        }
     } else {
         cached_value = std::nullopt;
     }
 }
 
 std::string SSTIterator::get_key() {
-    update_current();
-    if (cached_value.has_value()) {
-        return cached_value->first;
+    if (block_it != nullptr && !block_it->is_end()) {
+        return std::string(block_it->key());
     } else {
         throw std::out_of_range("SSTIterator is Invalid");
     }
 }
 
 std::string SSTIterator::get_val() {
-    update_current();
-    if (cached_value.has_value()) {
-        return cached_value->second;
+    if (block_it != nullptr && !block_it->is_end()) {
+        if (resolve_blob && block_it->is_blob_index()) {
+            return sst->get_blob(block_it->key(), block_it->value());
+        }
+        return std::string(block_it->value());
     } else {
         throw std::out_of_range("SSTIterator is Invalid");
     }
@@ -132,7 +140,8 @@ SSTIterator::merge_sst_iterator(std::vector<SSTIterator> iters, uint64_t trx_id)
     HeapIterator heap_end;
     for (auto iter : iters) {
         if (iter.is_vld() && !iter.is_end()) {
-            heap_beg.pqueue.emplace(iter.get_key(), iter.get_val(), -iter.sst->get_sst_id(), 0, iter.get_trx_id());
+            heap_beg.pqueue.emplace(iter.get_key(), iter.get_val(), -iter.sst->get_sst_id(), 0, iter.get_trx_id(),
+                iter.is_blob_index());
         }
     }
     return std::make_pair(heap_beg, heap_end);
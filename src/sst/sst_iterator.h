@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "iterator/iterator.h"
+#include "block/block_cache.h"
 #include "block/block_iterator.h"
 
 namespace LSMT {
@@ -16,7 +17,9 @@ class SSTIterator : public BaseIterator {
     friend class SST;
 
 public:
-    SSTIterator(std::shared_ptr<SST> sst, uint64_t trx_id);
+    // resolve_blob为false时BlobIndex不解析直接返回 供合并时原样写入新SST
+    SSTIterator(std::shared_ptr<SST> sst, uint64_t trx_id, CachePriority priority = CachePriority::NORMAL,
+        bool resolve_blob = true);
 
     SSTIterator(std::shared_ptr<SST> sst, const std::string &key, uint64_t trx_id);
 
@@ -38,6 +41,8 @@ public:
 
     virtual bool is_vld() const override;
 
+    virtual bool is_blob_index() const override;
+
     std::string get_key();
 
     std::string get_val();
@@ -53,6 +58,8 @@ private:
     size_t block_id;
     uint64_t max_trx_id;
     std::shared_ptr<BlockIterator> block_it;
+    CachePriority priority;
+    bool resolve_blob;
     mutable std::optional<std::pair<std::string, std::string>> cached_value;
 };
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "sst_properties.h"
+#include "utils/coding.h"
+#include "utils/crc32c.h"
+
+namespace LSMT {
+void SSTProperties::add_block(size_t entry_number) {
+    size_t bucket = 0;
+    while ((entry_number >> (bucket + 1)) != 0) {
+        ++bucket;
+    }
+    if (block_entry_histogram.size() <= bucket) {
+        block_entry_histogram.resize(bucket + 1, 0);
+    }
+    ++block_entry_histogram[bucket];
+}
+
+size_t SSTProperties::get_block_number() const {
+    size_t block_number = 0;
+    for (uint64_t count : block_entry_histogram) {
+        block_number += count;
+    }
+    return block_number;
+}
+
+double SSTProperties::get_tombstone_ratio() const {
+    return entry_number == 0 ? 0.0 : static_cast<double>(tombstone_number) / entry_number;
+}
+
+void SSTProperties::merge(const SSTProperties &other) {
+    entry_number += other.entry_number;
+    tombstone_number += other.tombstone_number;
+    key_number += other.key_number;
+    raw_key_size += other.raw_key_size;
+    raw_value_size += other.raw_value_size;
+    data_size += other.data_size;
+    raw_data_size += other.raw_data_size;
+    if (creation_time == 0 || (other.creation_time != 0 && other.creation_time < creation_time)) {
+        creation_time = other.creation_time;
+    }
+    if (block_entry_histogram.size() < other.block_entry_histogram.size()) {
+        block_entry_histogram.resize(other.block_entry_histogram.size(), 0);
+    }
+    for (size_t i = 0; i < other.block_entry_histogram.size(); ++i) {
+        block_entry_histogram[i] += other.block_entry_histogram[i];
+    }
+    for (const auto &[file_id, bytes] : other.blob_refs) {
+        blob_refs[file_id] += bytes;
+    }
+}
+
+std::vector<uint8_t> SSTProperties::encode() const {
+    std::vector<uint8_t> encoded;
+    for (uint64_t value : {entry_number, tombstone_number, key_number, raw_key_size, raw_value_size,
+            data_size, raw_data_size, creation_time}) {
+        put_varint(encoded, value);
+    }
+    put_varint(encoded, block_entry_histogram.size());
+    for (uint64_t count : block_entry_histogram) {
+        put_varint(encoded, count);
+    }
+    put_varint(encoded, blob_refs.size());
+    for (const auto &[file_id, bytes] : blob_refs) {
+        put_varint(encoded, file_id);
+        put_varint(encoded, bytes);
+    }
+
+    uint32_t hash_value = crc32c(encoded.data(), encoded.size());
+    encoded.resize(encoded.size() + sizeof(uint32_t));
+    memcpy(encoded.data() + encoded.size() - sizeof(uint32_t), &hash_value, sizeof(uint32_t));
+    return encoded;
+}
+
+SSTProperties SSTProperties::decode(const std::vector<uint8_t> &encoded) {
+    if (encoded.size() < sizeof(uint32_t)) {
+        throw std::runtime_error("Corrupted SST Properties");
+    }
+    size_t payload_size = encoded.size() - sizeof(uint32_t);
+    uint32_t hash_value;
+    memcpy(&hash_value, encoded.data() + payload_size, sizeof(uint32_t));
+    if (hash_value != crc32c(encoded.data(), payload_size)) {
+        throw std::runtime_error("SST Properties Hash Verification Error");
+    }
+
+    const uint8_t *pointer = encoded.data();
+    const uint8_t *limit = encoded.data() + payload_size;
+    auto read_varint = [&pointer, limit]() {
+        uint64_t value;
+        pointer = decode_varint(pointer, limit, value);
+        if (pointer == nullptr) {
+            throw std::runtime_error("Corrupted SST Properties");
+        }
+        return value;
+    };
+
+    SSTProperties properties;
+    for (uint64_t *value : {&properties.entry_number, &properties.tombstone_number, &properties.key_number,
+            &properties.raw_key_size, &properties.raw_value_size, &properties.data_size,
+            &properties.raw_data_size, &properties.creation_time}) {
+        *value = read_varint();
+    }
+    // 每一项至少1字节 避免损坏的数量导致过量分配
+    uint64_t histogram_number = read_varint();
+    if (histogram_number > static_cast<uint64_t>(limit - pointer)) {
+        throw std::runtime_error("Corrupted SST Properties");
+    }
+    properties.block_entry_histogram.resize(histogram_number);
+    for (uint64_t &count : properties.block_entry_histogram) {
+        count = read_varint();
+    }
+    uint64_t blob_number = read_varint();
+    for (uint64_t i = 0; i < blob_number; ++i) {
+        uint64_t file_id = read_varint();
+        properties.blob_refs[file_id] = read_varint();
+    }
+    if (pointer != limit) {
+        throw std::runtime_error("Corrupted SST Properties");
+    }
+    return properties;
+}
+} // LOG STRUCTURED MERGE TREE
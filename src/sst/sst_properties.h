@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/***
+-----------------------------------------------------------------------------------------------------------
+|                                           Properties Section                                            |
+-----------------------------------------------------------------------------------------------------------
+| Entry Number | Tombstone Number | Key Number | Raw Key Size | Raw Value Size | Data Size | Raw Data Size |
+-----------------------------------------------------------------------------------------------------------
+| Creation Time | Histogram Number | Bucket 1 | ... | Blob Number | File ID 1 | Bytes 1 | ... | CRC32C(4B) |
+-----------------------------------------------------------------------------------------------------------
+除CRC32C外全部为varint SST构建时统计 打开文件时读取后常驻内存 合并和估算时不需要扫描数据块
+Bucket i为元素数量在[2^i, 2^(i+1))之间的数据块数量
+***/
+
+namespace LSMT {
+struct SSTProperties {
+    uint64_t entry_number = 0;            // 包括同一个key的所有版本
+    uint64_t tombstone_number = 0;        // 值为空的删除标记
+    uint64_t key_number = 0;              // 不同key的数量
+    uint64_t raw_key_size = 0;
+    uint64_t raw_value_size = 0;          // 值保存在Blob文件中时只统计BlobIndex
+    uint64_t data_size = 0;               // 数据块段在文件中的大小 即压缩后的大小
+    uint64_t raw_data_size = 0;           // 数据块压缩前的编码大小
+    uint64_t creation_time = 0;           // Unix时间戳 单位秒
+    std::vector<uint64_t> block_entry_histogram;
+    std::map<uint64_t, uint64_t> blob_refs;  // 每个被引用的Blob文件及引用的字节数
+
+    void add_block(size_t entry_number);
+
+    size_t get_block_number() const;
+
+    double get_tombstone_ratio() const;
+
+    // 累加另一个SST的统计 用于按层或全局估算 creation_time取较早者
+    void merge(const SSTProperties &other);
+
+    std::vector<uint8_t> encode() const;
+
+    // 校验失败或数据不完整时抛出异常
+    static SSTProperties decode(const std::vector<uint8_t> &encoded);
+};
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "binary_fuse_filter.h"
+#include "hash.h"
+
+namespace LSMT {
+static uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static uint64_t splitmix64(uint64_t &state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t mulhi(uint64_t a, uint64_t b) {
+    return static_cast<uint64_t>((static_cast<__uint128_t>(a) * b) >> 64);
+}
+
+static double size_factor(size_t key_number) {
+    return key_number <= 1 ? 4.0 : std::max(1.125, 0.875 + 0.25 * std::log(1000000.0) / std::log(key_number));
+}
+
+BinaryFuseFilter::BinaryFuseFilter()
+: seed(0), segment_length(0), segment_length_mask(0), segment_count(0),
+  segment_count_length(0), array_length(0), fingerprint_bits(0) { }
+
+void BinaryFuseFilter::add(const std::string &) {
+    throw std::runtime_error("Binary Fuse Filter is Static and Cannot Add Keys After Build");
+}
+
+bool BinaryFuseFilter::possibly_contain(const std::string &key) const {
+    return possibly_contain_hash(murmur_hash64(key));
+}
+
+bool BinaryFuseFilter::possibly_contain_hash(uint64_t key_hash) const {
+    if (array_length == 0) {
+        return true;
+    }
+    uint64_t hash = mix64(key_hash + seed);
+    uint32_t pos[3];
+    positions(hash, pos);
+    uint32_t f = fingerprint(hash) ^ get_fingerprint(pos[0]) ^ get_fingerprint(pos[1]) ^ get_fingerprint(pos[2]);
+    return f == 0;
+}
+
+FilterType BinaryFuseFilter::get_type() const {
+    return FilterType::BINARY_FUSE;
+}
+
+void BinaryFuseFilter::init(size_t key_number, uint8_t fingerprint_bits) {
+    // 分段长度随键数量增长 上限为2^18 数组总长度约为键数量的1.125倍
+    this->fingerprint_bits = fingerprint_bits;
+    segment_length = key_number == 0 ? 4 : 1U << static_cast<int>(std::floor(std::log(key_number) / std::log(3.33) + 2.25));
+    segment_length = std::min<uint32_t>(std::max<uint32_t>(segment_length, 4), 1U << 18);
+    segment_length_mask = segment_length - 1;
+
+    size_t capacity = static_cast<size_t>(std::round(key_number * size_factor(key_number)));
+    int64_t init_segment_count = static_cast<int64_t>((capacity + segment_length - 1) / segment_length) - (ARITY - 1);
+    init_segment_count = std::max<int64_t>(init_segment_count, 1);
+    segment_count = static_cast<uint32_t>(init_segment_count);
+    array_length = (segment_count + ARITY - 1) * segment_length;
+    segment_count_length = segment_count * segment_length;
+
+    // 末尾预留4字节 读取指纹时一次读取32位无需判断越界
+    fingerprints.assign((static_cast<size_t>(array_length) * fingerprint_bits + 7) / 8 + sizeof(uint32_t), 0);
+}
+
+void BinaryFuseFilter::positions(uint64_t hash, uint32_t pos[3]) const {
+    uint64_t hl = mulhi(hash, segment_count_length);
+    pos[0] = static_cast<uint32_t>(hl);
+    pos[1] = pos[0] + segment_length;
+    pos[2] = pos[1] + segment_length;
+    pos[1] ^= static_cast<uint32_t>(hash >> 18) & segment_length_mask;
+    pos[2] ^= static_cast<uint32_t>(hash) & segment_length_mask;
+}
+
+uint32_t BinaryFuseFilter::position(uint32_t index, uint64_t hash) const {
+    uint64_t h = mulhi(hash, segment_count_length);
+    h += static_cast<uint64_t>(index) * segment_length;
+    uint64_t hh = hash & ((1ULL << 36) - 1);
+    h ^= (hh >> (36 - 18 * index)) & segment_length_mask;
+    return static_cast<uint32_t>(h);
+}
+
+uint32_t BinaryFuseFilter::fingerprint(uint64_t hash) const {
+    return static_cast<uint32_t>(hash ^ (hash >> 32)) & ((1U << fingerprint_bits) - 1);
+}
+
+uint32_t BinaryFuseFilter::get_fingerprint(size_t index) const {
+    size_t bit = index * fingerprint_bits;
+    uint32_t word;
+    std::memcpy(&word, &fingerprints[bit >> 3], sizeof(word));
+    return (word >> (bit & 7)) & ((1U << fingerprint_bits) - 1);
+}
+
+void BinaryFuseFilter::set_fingerprint(size_t index, uint32_t value) {
+    size_t bit = index * fingerprint_bits;
+    uint32_t mask = ((1U << fingerprint_bits) - 1) << (bit & 7);
+    uint32_t word;
+    std::memcpy(&word, &fingerprints[bit >> 3], sizeof(word));
+    word = (word & ~mask) | ((value << (bit & 7)) & mask);
+    std::memcpy(&fingerprints[bit >> 3], &word, sizeof(word));
+}
+
+bool BinaryFuseFilter::build(const std::vector<uint64_t> &hashes, double bits_per_key, BinaryFuseFilter &filter) {
+    std::vector<uint64_t> keys(hashes);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    // 指纹位数由每键位数除以空间放大系数得到 最多16位
+    double bits = bits_per_key / size_factor(keys.size());
+    filter.init(keys.size(), static_cast<uint8_t>(std::clamp<double>(std::round(bits), 1, 16)));
+
+    size_t size = keys.size();
+    size_t capacity = filter.array_length;
+    std::vector<uint64_t> reverse_order(size);
+    std::vector<uint8_t> reverse_h(size);
+    std::vector<uint32_t> alone(capacity);
+    std::vector<uint8_t> t2count(capacity);
+    std::vector<uint64_t> t2hash(capacity);
+    uint64_t rng_state = 0x726b2b9d438b9d4dULL;
+
+    for (int loop = 0; ; ++loop) {
+        if (loop >= MAX_ITERATIONS) {
+            return false;
+        }
+        filter.seed = splitmix64(rng_state);
+        std::fill(t2count.begin(), t2count.end(), 0);
+        std::fill(t2hash.begin(), t2hash.end(), 0);
+
+        // t2count高6位记录映射到该位置的键数量 低2位记录这些键在该位置的序号异或
+        bool error = false;
+        for (uint64_t key : keys) {
+            uint64_t hash = mix64(key + filter.seed);
+            for (uint32_t index = 0; index < ARITY; ++index) {
+                uint32_t h = filter.position(index, hash);
+                t2count[h] += 4;
+                t2count[h] ^= index;
+                t2hash[h] ^= hash;
+                error = error || t2count[h] < 4;
+            }
+        }
+        if (error) {
+            continue;
+        }
+
+        // 剥离: 反复取出只被一个键映射的位置 将该键压栈并从其余两个位置移除
+        size_t queue_size = 0;
+        for (size_t i = 0; i < capacity; ++i) {
+            alone[queue_size] = i;
+            queue_size += (t2count[i] >> 2) == 1 ? 1 : 0;
+        }
+        size_t stack_size = 0;
+        uint32_t h012[5];
+        while (queue_size > 0) {
+            uint32_t index = alone[--queue_size];
+            if ((t2count[index] >> 2) != 1) {
+                continue;
+            }
+            uint64_t hash = t2hash[index];
+            uint8_t found = t2count[index] & 3;
+            h012[0] = filter.position(0, hash);
+            h012[1] = filter.position(1, hash);
+            h012[2] = filter.position(2, hash);
+            h012[3] = h012[0];
+            h012[4] = h012[1];
+            reverse_h[stack_size] = found;
+            reverse_order[stack_size] = hash;
+            stack_size++;
+
+            for (uint32_t k = 1; k < ARITY; ++k) {
+                uint32_t other = h012[found + k];
+                alone[queue_size] = other;
+                queue_size += (t2count[other] >> 2) == 2 ? 1 : 0;
+                t2count[other] -= 4;
+                t2count[other] ^= (found + k) % ARITY;
+                t2hash[other] ^= hash;
+            }
+        }
+        if (stack_size == size) {
+            break;
+        }
+    }
+
+    // 按剥离的逆序赋值 保证每个键三个位置的指纹异或等于其指纹
+    for (size_t i = size; i-- > 0;) {
+        uint64_t hash = reverse_order[i];
+        uint8_t found = reverse_h[i];
+        uint32_t h012[5];
+        h012[0] = filter.position(0, hash);
+        h012[1] = filter.position(1, hash);
+        h012[2] = filter.position(2, hash);
+        h012[3] = h012[0];
+        h012[4] = h012[1];
+        filter.set_fingerprint(h012[found], filter.fingerprint(hash) ^
+            filter.get_fingerprint(h012[found + 1]) ^ filter.get_fingerprint(h012[found + 2]));
+    }
+    return true;
+}
+
+std::vector<uint8_t> BinaryFuseFilter::encode() {
+    std::vector<uint8_t> data;
+    auto append = [&data](const void *value, size_t size) {
+        data.insert(data.end(), static_cast<const uint8_t*>(value), static_cast<const uint8_t*>(value) + size);
+    };
+    append(&seed, sizeof(seed));
+    append(&segment_length, sizeof(segment_length));
+    append(&segment_count, sizeof(segment_count));
+    append(&array_length, sizeof(array_length));
+    append(&fingerprint_bits, sizeof(fingerprint_bits));
+    data.insert(data.end(), fingerprints.begin(), fingerprints.end());
+    return data;
+}
+
+BinaryFuseFilter BinaryFuseFilter::decode(const std::vector<uint8_t> &data) {
+    return decode(data.data(), data.size());
+}
+
+BinaryFuseFilter BinaryFuseFilter::decode(const uint8_t *data, size_t size) {
+    BinaryFuseFilter filter;
+    size_t index = 0;
+    auto read = [data, size, &index](void *value, size_t length) {
+        if (index + length > size) {
+            throw std::runtime_error("Corrupted Binary Fuse Filter");
+        }
+        std::memcpy(value, &data[index], length);
+        index += length;
+    };
+    read(&filter.seed, sizeof(filter.seed));
+    read(&filter.segment_length, sizeof(filter.segment_length));
+    read(&filter.segment_count, sizeof(filter.segment_count));
+    read(&filter.array_length, sizeof(filter.array_length));
+    read(&filter.fingerprint_bits, sizeof(filter.fingerprint_bits));
+
+    size_t fingerprint_size = (static_cast<size_t>(filter.array_length) * filter.fingerprint_bits + 7) / 8 + sizeof(uint32_t);
+    if (filter.fingerprint_bits == 0 || filter.fingerprint_bits > 16 || size - index != fingerprint_size) {
+        throw std::runtime_error("Corrupted Binary Fuse Filter");
+    }
+    // 过滤器段没有校验值 三个位置都必须落在指纹数组内 否则查询时越界读取
+    if (filter.segment_length == 0 || (filter.segment_length & (filter.segment_length - 1)) != 0 ||
+            filter.segment_count == 0 ||
+            filter.array_length < (static_cast<uint64_t>(filter.segment_count) + ARITY - 1) * filter.segment_length) {
+        throw std::runtime_error("Corrupted Binary Fuse Filter");
+    }
+    filter.segment_length_mask = filter.segment_length - 1;
+    filter.segment_count_length = filter.segment_count * filter.segment_length;
+    filter.fingerprints.assign(data + index, data + size);
+    return filter;
+}
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "filter.h"
+
+/***
+-----------------------------------------------------------------------------------------------------------------
+|                                             Binary Fuse Filter                                                |
+-----------------------------------------------------------------------------------------------------------------
+| Seed(8B) | Segment Length(4B) | Segment Count(4B) | Array Length(4B) | Fingerprint Bits(1B) | Fingerprints    |
+-----------------------------------------------------------------------------------------------------------------
+静态过滤器: 构建时一次性给定全部键 每个键映射到三个相邻分段中的位置 三个位置的指纹异或等于键的指纹
+指纹按位紧凑存储 误判率约为2^-fingerprint_bits 空间约为1.125 * fingerprint_bits位每键
+***/
+
+namespace LSMT {
+class BinaryFuseFilter : public BaseFilter {
+public:
+    BinaryFuseFilter();
+
+    void add(const std::string &key) override;
+
+    bool possibly_contain(const std::string &key) const override;
+
+    bool possibly_contain_hash(uint64_t hash) const;
+
+    std::vector<uint8_t> encode() override;
+
+    FilterType get_type() const override;
+
+    // 构建失败(多次重试仍无法剥离)时返回false 由调用方回退到其他过滤器
+    static bool build(const std::vector<uint64_t> &hashes, double bits_per_key, BinaryFuseFilter &filter);
+
+    static BinaryFuseFilter decode(const std::vector<uint8_t> &data);
+
+    static BinaryFuseFilter decode(const uint8_t *data, size_t size);
+
+private:
+    void init(size_t key_number, uint8_t fingerprint_bits);
+
+    void positions(uint64_t hash, uint32_t pos[3]) const;
+
+    uint32_t position(uint32_t index, uint64_t hash) const;
+
+    uint32_t fingerprint(uint64_t hash) const;
+
+    uint32_t get_fingerprint(size_t index) const;
+
+    void set_fingerprint(size_t index, uint32_t value);
+
+private:
+    static constexpr uint32_t ARITY = 3;
+    static constexpr int MAX_ITERATIONS = 100;
+
+    uint64_t seed;
+    uint32_t segment_length;
+    uint32_t segment_length_mask;
+    uint32_t segment_count;
+    uint32_t segment_count_length;
+    uint32_t array_length;
+    uint8_t fingerprint_bits;
+    std::vector<uint8_t> fingerprints;
+};
+} // LOG STRUCTURED MERGE TREE
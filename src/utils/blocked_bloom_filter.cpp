@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "blocked_bloom_filter.h"
+#include "hash.h"
+
+namespace LSMT {
+BlockedBloomFilter::BlockedBloomFilter() : line_number(0), hash_number(0) { }
+
+BlockedBloomFilter::BlockedBloomFilter(size_t expected_elements, double false_positive_rate) {
+    *this = with_bits_per_key(expected_elements, -std::log(false_positive_rate) / std::pow(std::log(2), 2));
+}
+
+BlockedBloomFilter BlockedBloomFilter::with_bits_per_key(size_t key_number, double bits_per_key) {
+    // 每键位数决定行数 最优哈希函数个数为bits_per_key * ln2
+    BlockedBloomFilter bf;
+    double m = std::max<double>(key_number, 1) * bits_per_key;
+    bf.line_number = static_cast<uint32_t>(std::max<double>(std::ceil(m / LINE_BITS), 1));
+    bf.hash_number = static_cast<uint8_t>(std::clamp<double>(std::round(bits_per_key * std::log(2)), 1, 16));
+    bf.lines.assign(bf.line_number, FilterLine{});
+    return bf;
+}
+
+void BlockedBloomFilter::add(const std::string &key) {
+    add_hash(murmur_hash64(key));
+}
+
+bool BlockedBloomFilter::possibly_contain(const std::string &key) const {
+    return possibly_contain_hash(murmur_hash64(key));
+}
+
+void BlockedBloomFilter::add_hash(uint64_t hash) {
+    uint64_t mask[8];
+    make_mask(hash, mask);
+
+    FilterLine &line = lines[line_of(hash)];
+    for (size_t i = 0; i < 8; ++i) {
+        line.words[i] |= mask[i];
+    }
+}
+
+bool BlockedBloomFilter::possibly_contain_hash(uint64_t hash) const {
+    if (line_number == 0) {
+        return true;
+    }
+    uint64_t mask[8];
+    make_mask(hash, mask);
+
+    // 整行按字比较 不含分支便于编译器向量化
+    const FilterLine &line = lines[line_of(hash)];
+    uint64_t missing = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        missing |= mask[i] & ~line.words[i];
+    }
+    return missing == 0;
+}
+
+FilterType BlockedBloomFilter::get_type() const {
+    return FilterType::BLOCKED_BLOOM;
+}
+
+void BlockedBloomFilter::make_mask(uint64_t hash, uint64_t mask[8]) const {
+    // 双重哈希: bit_i = h1 + i * h2 (mod 512) h2为奇数保证探测位分散
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>((hash * 0x9e3779b97f4a7c15ULL) >> 32) | 1;
+    std::fill(mask, mask + 8, 0);
+    for (uint8_t i = 0; i < hash_number; ++i) {
+        uint32_t bit = (h1 + i * h2) & (LINE_BITS - 1);
+        mask[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+size_t BlockedBloomFilter::line_of(uint64_t hash) const {
+    // 用乘法代替取模将高32位映射到[0, line_number)
+    return static_cast<size_t>(((hash >> 32) * line_number) >> 32);
+}
+
+std::vector<uint8_t> BlockedBloomFilter::encode() {
+    std::vector<uint8_t> data(sizeof(line_number) + sizeof(hash_number) + lines.size() * sizeof(FilterLine));
+    size_t index = 0;
+
+    std::memcpy(&data[index], &line_number, sizeof(line_number));
+    index += sizeof(line_number);
+
+    std::memcpy(&data[index], &hash_number, sizeof(hash_number));
+    index += sizeof(hash_number);
+
+    if (!lines.empty()) {
+        std::memcpy(&data[index], lines.data(), lines.size() * sizeof(FilterLine));
+    }
+    return data;
+}
+
+BlockedBloomFilter BlockedBloomFilter::decode(const std::vector<uint8_t> &data) {
+    return decode(data.data(), data.size());
+}
+
+BlockedBloomFilter BlockedBloomFilter::decode(const uint8_t *data, size_t size) {
+    BlockedBloomFilter bf;
+    size_t index = 0;
+
+    if (size < sizeof(bf.line_number) + sizeof(bf.hash_number)) {
+        throw std::runtime_error("Corrupted Blocked Bloom Filter");
+    }
+    std::memcpy(&bf.line_number, &data[index], sizeof(bf.line_number));
+    index += sizeof(bf.line_number);
+
+    std::memcpy(&bf.hash_number, &data[index], sizeof(bf.hash_number));
+    index += sizeof(bf.hash_number);
+
+    if (size - index != static_cast<size_t>(bf.line_number) * sizeof(FilterLine)) {
+        throw std::runtime_error("Corrupted Blocked Bloom Filter");
+    }
+    bf.lines.resize(bf.line_number);
+    if (bf.line_number > 0) {
+        std::memcpy(bf.lines.data(), &data[index], bf.lines.size() * sizeof(FilterLine));
+    }
+    return bf;
+}
+} // LOG STRUCTURED MERGE TREE
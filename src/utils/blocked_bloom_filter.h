@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "filter.h"
+
+/***
+---------------------------------------------------------------
+|                    Blocked Bloom Filter                     |
+---------------------------------------------------------------
+| Line Numbers(4B) | Hash Numbers(1B) | Line 1 | ... | Line N |
+---------------------------------------------------------------
+每个Line为一个64字节缓存行(8个uint64_t) 一个键只计算一次64位哈希
+高32位选择缓存行 低位通过双重哈希在该缓存行内生成所有探测位
+***/
+
+namespace LSMT {
+struct alignas(64) FilterLine {
+    uint64_t words[8];
+};
+
+class BlockedBloomFilter : public BaseFilter {
+public:
+    BlockedBloomFilter();
+
+    BlockedBloomFilter(size_t expected_elements, double false_positive_rate);
+
+    void add(const std::string &key) override;
+
+    bool possibly_contain(const std::string &key) const override;
+
+    std::vector<uint8_t> encode() override;
+
+    FilterType get_type() const override;
+
+    void add_hash(uint64_t hash);
+
+    bool possibly_contain_hash(uint64_t hash) const;
+
+    static BlockedBloomFilter with_bits_per_key(size_t key_number, double bits_per_key);
+
+    static BlockedBloomFilter decode(const std::vector<uint8_t> &data);
+
+    static BlockedBloomFilter decode(const uint8_t *data, size_t size);
+
+private:
+    void make_mask(uint64_t hash, uint64_t mask[8]) const;
+
+    size_t line_of(uint64_t hash) const;
+
+private:
+    static constexpr size_t LINE_BITS = 512;
+
+    uint32_t line_number;
+    uint8_t hash_number;
+    std::vector<FilterLine> lines;
+};
+} // LOG STRUCTURED MERGE TREE
@@ -1,32 +1,40 @@
+#include <stdexcept>
+
 #include "bloom_filter.h"
 
 namespace LSMT {
-BloomFilter::BloomFilter() { }
+BloomFilter::BloomFilter() : bits_number(0), hash_number(0) { }
 
 BloomFilter::BloomFilter(size_t expected_elements, double false_positive_rate) {
     double m = -static_cast<double>(expected_elements) * std::log(false_positive_rate) / std::pow(std::log(2), 2);
     bits_number = static_cast<size_t>(std::ceil(m));
     hash_number = static_cast<size_t>(std::ceil(m / expected_elements * std::log(2)));
-    bits.resize(bits_number, false);
+    bits.assign((bits_number + 7) / 8, 0);
 }
 
 void BloomFilter::add(const std::string &key) {
     for (size_t i = 0; i < hash_number; ++i) {
-        bits[hash(key, i)] = true;
+        size_t bit = hash(key, i);
+        bits[bit >> 3] |= static_cast<uint8_t>(1 << (bit & 7));
     }
 }
 
 bool BloomFilter::possibly_contain(const std::string &key) const {
     for (size_t i = 0; i < hash_number; ++i) {
-        if (bits[hash(key, i)] == false) {
+        size_t bit = hash(key, i);
+        if (((bits[bit >> 3] >> (bit & 7)) & 1) == 0) {
             return false;
         }
     }
     return true;
 }
 
+FilterType BloomFilter::get_type() const {
+    return FilterType::BLOOM;
+}
+
 void BloomFilter::clear() {
-    bits.assign(bits.size(), false);
+    bits.assign(bits.size(), 0);
 }
 
 size_t BloomFilter::hash(const std::string &key, size_t idx) const {
@@ -35,6 +43,7 @@ size_t BloomFilter::hash(const std::string &key, size_t idx) const {
 
 std::vector<uint8_t> BloomFilter::encode() {
     std::vector<uint8_t> data;
+    data.reserve(sizeof(bits_number) + sizeof(hash_number) + bits.size());
 
     data.insert(data.end(), reinterpret_cast<const uint8_t*>(&bits_number),
                 reinterpret_cast<const uint8_t*>(&bits_number) + sizeof(bits_number));
@@ -42,34 +51,34 @@ std::vector<uint8_t> BloomFilter::encode() {
     data.insert(data.end(), reinterpret_cast<const uint8_t*>(&hash_number),
                 reinterpret_cast<const uint8_t*>(&hash_number) + sizeof(hash_number));
 
-    for (size_t i = 0; i < (bits_number + 7) / 8; ++i) {
-        uint8_t byte = 0;
-        for (size_t j = 0; j < 8 && i * 8 + j < bits_number; ++j) {
-            byte = byte | (bits[i * 8 + j] << j);
-        }
-        data.push_back(byte);
-    }
+    data.insert(data.end(), bits.begin(), bits.end());
 
     return data;
 }
 
 BloomFilter BloomFilter::decode(const std::vector<uint8_t> &data) {
+    return decode(data.data(), data.size());
+}
+
+BloomFilter BloomFilter::decode(const uint8_t *data, size_t size) {
     BloomFilter bf;
     size_t index = 0;
 
+    if (size < sizeof(bf.bits_number) + sizeof(bf.hash_number)) {
+        throw std::runtime_error("Corrupted Bloom Filter");
+    }
     std::memcpy(&bf.bits_number, &data[index], sizeof(bf.bits_number));
     index += sizeof(bf.bits_number);
 
     std::memcpy(&bf.hash_number, &data[index], sizeof(bf.hash_number));
     index += sizeof(bf.hash_number);
 
-    bf.bits.resize(bf.bits_number, false);
-    for (size_t i = 0; i < (bf.bits_number + 7) / 8; ++i) {
-        uint8_t byte = data[index++];
-        for (size_t j = 0; j < 8 && i * 8 + j < bf.bits_number; ++j) {
-            bf.bits[i * 8 + j] = (byte >> j) & 1;
-        }
+    // 位数组按字节整体拷贝 不再逐位解码
+    size_t byte_number = (bf.bits_number + 7) / 8;
+    if (size - index < byte_number) {
+        throw std::runtime_error("Corrupted Bloom Filter");
     }
+    bf.bits.assign(data + index, data + index + byte_number);
 
     return bf;
 }
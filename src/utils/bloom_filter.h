@@ -7,30 +7,45 @@
 #include <string>
 #include <vector>
 
+#include "filter.h"
+
+/***
+---------------------------------------------------------
+|                     Bloom Filter                      |
+---------------------------------------------------------
+| Bits Number(8B) | Hash Numbers(8B) | Bits(Bits Number) |
+---------------------------------------------------------
+第i位位于第i / 8个字节的第i % 8位 内存中保持与文件相同的字节布局 编解码只需memcpy
+***/
+
 namespace LSMT {
 
-class BloomFilter {
+class BloomFilter : public BaseFilter {
 public:
     BloomFilter();
 
     BloomFilter(size_t expected_elements, double false_positive_rate);
 
-    void add(const std::string &key);
+    void add(const std::string &key) override;
 
-    bool possibly_contain(const std::string &key) const;
+    bool possibly_contain(const std::string &key) const override;
 
     void clear();
 
-    std::vector<uint8_t> encode();
+    std::vector<uint8_t> encode() override;
+
+    FilterType get_type() const override;
 
     static BloomFilter decode(const std::vector<uint8_t> &data);
 
+    static BloomFilter decode(const uint8_t *data, size_t size);
+
 private:
     size_t hash(const std::string &key, size_t idx) const;
 
 private:
     size_t bits_number;
     size_t hash_number;
-    std::vector<bool> bits;
+    std::vector<uint8_t> bits;
 };
 } // LOG STRUCTURED MERGE TREE
\ No newline at end of file
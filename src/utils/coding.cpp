@@ -0,0 +1,48 @@
+#include "coding.h"
+
+namespace LSMT {
+size_t varint_length(uint64_t value) {
+    size_t length = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++length;
+    }
+    return length;
+}
+
+size_t encode_varint(uint8_t *dst, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        dst[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    dst[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+void put_varint(std::vector<uint8_t> &dst, uint64_t value) {
+    size_t pos = dst.size();
+    dst.resize(pos + varint_length(value));
+    encode_varint(dst.data() + pos, value);
+}
+
+const uint8_t *decode_varint(const uint8_t *src, const uint8_t *limit, uint64_t &value) {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64 && src < limit; shift += 7) {
+        uint64_t byte = *src++;
+        value |= (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return src;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+} // LOG STRUCTURED MERGE TREE
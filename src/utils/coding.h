@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LSMT {
+// 变长整数编码 每字节低7位存放数据 最高位为1表示后面还有字节 小端序
+size_t varint_length(uint64_t value);
+
+// 写入dst并返回写入的字节数 dst需要预留varint_length(value)字节
+size_t encode_varint(uint8_t *dst, uint64_t value);
+
+void put_varint(std::vector<uint8_t> &dst, uint64_t value);
+
+// 从[src, limit)解析变长整数 返回下一个字节的位置 数据不完整或超过64位时返回nullptr
+const uint8_t *decode_varint(const uint8_t *src, const uint8_t *limit, uint64_t &value);
+
+// zigzag映射 绝对值较小的负数也能编码为较小的无符号数
+uint64_t zigzag_encode(int64_t value);
+
+int64_t zigzag_decode(uint64_t value);
+} // LOG STRUCTURED MERGE TREE
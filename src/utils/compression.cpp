@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "compression.h"
+
+#ifdef LSMT_WITH_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef LSMT_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace LSMT {
+CompressionType to_compression_type(const std::string &name) {
+    if (name == "lz4") {
+        return CompressionType::LZ4;
+    } else if (name == "zstd") {
+        return CompressionType::ZSTD;
+    } else {
+        return CompressionType::NONE;
+    }
+}
+
+bool compression_supported(CompressionType type) {
+#ifndef LSMT_WITH_ZSTD
+    if (type == CompressionType::ZSTD) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+#ifndef LSMT_WITH_LZ4
+static constexpr size_t MIN_MATCH     = 4;
+static constexpr size_t LAST_LITERALS = 5;   // 块末尾至少保留5字节字面量
+static constexpr size_t MFLIMIT       = 12;  // 最后一个匹配必须在块末尾12字节之前开始
+static constexpr size_t MAX_OFFSET    = 65535;
+static constexpr size_t HASH_LOG      = 12;
+
+static void write_length(std::vector<uint8_t> &output, size_t length) {
+    while (length >= 255) {
+        output.push_back(255);
+        length -= 255;
+    }
+    output.push_back(length);
+}
+
+static void write_sequence(std::vector<uint8_t> &output, const uint8_t *literal, size_t literal_len,
+        size_t offset, size_t match_len) {
+    // Token高4位为字面量长度 低4位为匹配长度减4 取值15时后续字节继续累加
+    size_t token_pos = output.size();
+    output.push_back(std::min<size_t>(literal_len, 15) << 4);
+    if (literal_len >= 15) {
+        write_length(output, literal_len - 15);
+    }
+    output.insert(output.end(), literal, literal + literal_len);
+    if (match_len == 0) {
+        return;
+    }
+    output.push_back(offset & 0xFF);
+    output.push_back(offset >> 8);
+    match_len -= MIN_MATCH;
+    output[token_pos] |= std::min<size_t>(match_len, 15);
+    if (match_len >= 15) {
+        write_length(output, match_len - 15);
+    }
+}
+
+// 内置的LZ4块格式压缩 只用单个哈希表查找4字节匹配
+static void lz4_compress(const uint8_t *data, size_t size, std::vector<uint8_t> &output) {
+    std::vector<uint32_t> table(1 << HASH_LOG, 0);  // 记录位置加1 0表示空
+    size_t pos = 0, anchor = 0;
+    while (size >= MFLIMIT && pos + MFLIMIT <= size) {
+        uint32_t sequence;
+        memcpy(&sequence, data + pos, sizeof(uint32_t));
+        uint32_t hash = (sequence * 2654435761U) >> (32 - HASH_LOG);
+        size_t candidate = table[hash];
+        table[hash] = pos + 1;
+        if (candidate == 0 || pos + 1 - candidate > MAX_OFFSET ||
+                memcmp(data + candidate - 1, data + pos, MIN_MATCH) != 0) {
+            ++pos;
+            continue;
+        }
+        size_t match = candidate - 1;
+        size_t match_len = MIN_MATCH;
+        while (pos + match_len < size - LAST_LITERALS && data[match + match_len] == data[pos + match_len]) {
+            ++match_len;
+        }
+        write_sequence(output, data + anchor, pos - anchor, pos - match, match_len);
+        pos += match_len;
+        anchor = pos;
+    }
+    write_sequence(output, data + anchor, size - anchor, 0, 0);
+}
+
+static size_t read_length(const uint8_t *data, size_t size, size_t &pos) {
+    size_t length = 0;
+    uint8_t byte;
+    do {
+        if (pos >= size) {
+            throw std::runtime_error("Corrupted Compressed Data");
+        }
+        byte = data[pos++];
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+static void lz4_uncompress(const uint8_t *data, size_t size, std::vector<uint8_t> &output, size_t expected) {
+    size_t pos = 0;
+    while (pos < size) {
+        uint8_t token = data[pos++];
+        size_t literal_len = token >> 4;
+        if (literal_len == 15) {
+            literal_len += read_length(data, size, pos);
+        }
+        if (literal_len > size - pos || literal_len > expected - output.size()) {
+            throw std::runtime_error("Corrupted Compressed Data");
+        }
+        output.insert(output.end(), data + pos, data + pos + literal_len);
+        pos += literal_len;
+        // 最后一个序列只有字面量
+        if (pos == size) {
+            break;
+        }
+
+        if (pos + 2 > size) {
+            throw std::runtime_error("Corrupted Compressed Data");
+        }
+        size_t offset = data[pos] | (data[pos + 1] << 8);
+        pos += 2;
+        size_t match_len = token & 0x0F;
+        if (match_len == 15) {
+            match_len += read_length(data, size, pos);
+        }
+        match_len += MIN_MATCH;
+        if (offset == 0 || offset > output.size() || match_len > expected - output.size()) {
+            throw std::runtime_error("Corrupted Compressed Data");
+        }
+        // 匹配可能与输出重叠 需要逐字节复制
+        size_t match = output.size() - offset;
+        for (size_t i = 0; i < match_len; ++i) {
+            output.push_back(output[match + i]);
+        }
+    }
+}
+#endif
+
+bool compress(CompressionType &type, const uint8_t *data, size_t size, double max_ratio, std::vector<uint8_t> &output) {
+    if (type == CompressionType::NONE || size > UINT32_MAX) {
+        return false;
+    }
+    if (!compression_supported(type)) {
+        type = CompressionType::LZ4;
+    }
+
+    output.resize(sizeof(uint32_t));
+    uint32_t uncompressed_size = size;
+    memcpy(output.data(), &uncompressed_size, sizeof(uint32_t));
+    if (type == CompressionType::LZ4) {
+#ifdef LSMT_WITH_LZ4
+        output.resize(sizeof(uint32_t) + LZ4_compressBound(size));
+        int len = LZ4_compress_default(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(output.data()) +
+            sizeof(uint32_t), size, output.size() - sizeof(uint32_t));
+        if (len <= 0) {
+            return false;
+        }
+        output.resize(sizeof(uint32_t) + len);
+#else
+        output.reserve(sizeof(uint32_t) + size + size / 255 + 16);
+        lz4_compress(data, size, output);
+#endif
+    } else {
+#ifdef LSMT_WITH_ZSTD
+        output.resize(sizeof(uint32_t) + ZSTD_compressBound(size));
+        size_t len = ZSTD_compress(output.data() + sizeof(uint32_t), output.size() - sizeof(uint32_t), data, size, 3);
+        if (ZSTD_isError(len)) {
+            return false;
+        }
+        output.resize(sizeof(uint32_t) + len);
+#endif
+    }
+    return output.size() <= size * max_ratio;
+}
+
+std::vector<uint8_t> uncompress(CompressionType type, const uint8_t *data, size_t size) {
+    if (type == CompressionType::NONE) {
+        return std::vector<uint8_t>(data, data + size);
+    }
+    if (size < sizeof(uint32_t)) {
+        throw std::runtime_error("Corrupted Compressed Data");
+    }
+    uint32_t uncompressed_size;
+    memcpy(&uncompressed_size, data, sizeof(uint32_t));
+    data += sizeof(uint32_t);
+    size -= sizeof(uint32_t);
+
+    std::vector<uint8_t> output;
+    if (type == CompressionType::LZ4) {
+#ifdef LSMT_WITH_LZ4
+        output.resize(uncompressed_size);
+        int len = LZ4_decompress_safe(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(output.data()),
+            size, uncompressed_size);
+        if (len < 0) {
+            throw std::runtime_error("Corrupted Compressed Data");
+        }
+        output.resize(len);
+#else
+        output.reserve(uncompressed_size);
+        lz4_uncompress(data, size, output, uncompressed_size);
+#endif
+    } else if (type == CompressionType::ZSTD) {
+#ifdef LSMT_WITH_ZSTD
+        output.resize(uncompressed_size);
+        size_t len = ZSTD_decompress(output.data(), uncompressed_size, data, size);
+        if (ZSTD_isError(len)) {
+            throw std::runtime_error("Corrupted Compressed Data");
+        }
+        output.resize(len);
+#else
+        throw std::runtime_error("Unsupported Compression Type");
+#endif
+    } else {
+        throw std::runtime_error("Unknown Compression Type");
+    }
+
+    if (output.size() != uncompressed_size) {
+        throw std::runtime_error("Corrupted Compressed Data");
+    }
+    return output;
+}
+} // LOG STRUCTURED MERGE TREE
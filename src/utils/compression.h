@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***
+--------------------------------------------------------
+|                  Compressed Payload                  |
+--------------------------------------------------------
+| Uncompressed Size(4B) | Compressed Data(Compressed Len) |
+--------------------------------------------------------
+LZ4使用LZ4块格式 系统没有liblz4时使用内置的兼容实现 两者产生的数据可以互相解压
+Zstd只在系统存在libzstd时可用 否则压缩时回退到LZ4
+***/
+
+namespace LSMT {
+enum class CompressionType : uint8_t {
+    NONE = 0,  // 不压缩
+    LZ4 = 1,   // 压缩解压速度快 适合较上层的SST
+    ZSTD = 2,  // 压缩率更高 适合数据量最大的深层SST
+};
+
+CompressionType to_compression_type(const std::string &name);
+
+// 当前构建是否链接了该压缩算法的实现 LZ4始终可用
+bool compression_supported(CompressionType type);
+
+// 压缩data 实际使用的算法写入type 压缩后大小超过原大小的max_ratio倍时不压缩并返回false
+bool compress(CompressionType &type, const uint8_t *data, size_t size, double max_ratio, std::vector<uint8_t> &output);
+
+// 解压compress生成的数据 数据损坏或算法不可用时抛出异常
+std::vector<uint8_t> uncompress(CompressionType type, const uint8_t *data, size_t size);
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,79 @@
+#include "count_min_sketch.h"
+
+namespace LSMT {
+static const uint64_t ROW_SEEDS[] = {
+    0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+};
+
+static size_t sketch_width(size_t capacity) {
+    // 每行计数器数量取不小于容量的2的幂 每个uint64_t存放16个4bit计数器
+    size_t width = 16;
+    while (width < capacity) {
+        width <<= 1;
+    }
+    return width;
+}
+
+CountMinSketch::CountMinSketch(size_t capacity)
+: table(SKETCH_DEPTH * sketch_width(capacity) / 16), additions(0) {
+    width_mask = sketch_width(capacity) - 1;
+    sample_size = 10 * std::max<size_t>(capacity, 1);
+    clear();
+}
+
+size_t CountMinSketch::index_of(uint64_t hash, size_t row) const {
+    uint64_t h = (hash ^ ROW_SEEDS[row]) * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 32;
+    return row * (width_mask + 1) + (h & width_mask);
+}
+
+void CountMinSketch::increment(uint64_t hash) {
+    // 保守更新: 只增加等于最小值的计数器 降低高估误差
+    uint8_t min_count = estimate(hash);
+    if (min_count >= MAX_COUNTER) {
+        return;
+    }
+    for (size_t row = 0; row < SKETCH_DEPTH; ++row) {
+        size_t index = index_of(hash, row);
+        size_t shift = (index & 15) << 2;
+        auto &word = table[index >> 4];
+        uint64_t old_word = word.load(std::memory_order_relaxed);
+        while (((old_word >> shift) & 0xF) == min_count) {
+            if (word.compare_exchange_weak(old_word, old_word + (1ULL << shift), std::memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
+    if (additions.fetch_add(1, std::memory_order_relaxed) + 1 == sample_size) {
+        reset();
+    }
+}
+
+uint8_t CountMinSketch::estimate(uint64_t hash) const {
+    uint8_t min_count = MAX_COUNTER;
+    for (size_t row = 0; row < SKETCH_DEPTH; ++row) {
+        size_t index = index_of(hash, row);
+        uint64_t word = table[index >> 4].load(std::memory_order_relaxed);
+        uint8_t count = (word >> ((index & 15) << 2)) & 0xF;
+        min_count = std::min(min_count, count);
+    }
+    return min_count;
+}
+
+void CountMinSketch::reset() {
+    // 老化: 所有计数器减半 使历史热点逐渐失效
+    for (auto &word : table) {
+        uint64_t old_word = word.load(std::memory_order_relaxed);
+        while (!word.compare_exchange_weak(old_word, (old_word >> 1) & 0x7777777777777777ULL,
+                std::memory_order_relaxed)) { }
+    }
+    additions.store(sample_size / 2, std::memory_order_relaxed);
+}
+
+void CountMinSketch::clear() {
+    for (auto &word : table) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    additions.store(0, std::memory_order_relaxed);
+}
+} // LOG STRUCTURED MERGE TREE
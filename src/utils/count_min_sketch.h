@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/***
+---------------------------------------------------------------------
+|                      Count-Min Sketch (4bit)                      |
+---------------------------------------------------------------------
+| Row 0: Counter 0 | Counter 1 | ... | Counter W (16 per uint64_t)  |
+| Row 1: Counter 0 | Counter 1 | ... | Counter W                    |
+| Row 2: ...                                                        |
+| Row 3: ...                                                        |
+---------------------------------------------------------------------
+***/
+
+// 计数器使用relaxed原子操作 允许在共享锁下并发计数 频率本身即为估计值
+namespace LSMT {
+class CountMinSketch {
+public:
+    CountMinSketch(size_t capacity);
+
+    void increment(uint64_t hash);
+
+    uint8_t estimate(uint64_t hash) const;
+
+    void reset();
+
+    void clear();
+
+private:
+    size_t index_of(uint64_t hash, size_t row) const;
+
+private:
+    static constexpr size_t SKETCH_DEPTH = 4;
+    static constexpr uint8_t MAX_COUNTER = 15;
+
+    std::vector<std::atomic<uint64_t>> table;
+    size_t width_mask;
+    size_t sample_size;
+    std::atomic<size_t> additions;
+};
+} // LOG STRUCTURED MERGE TREE
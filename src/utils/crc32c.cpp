@@ -0,0 +1,84 @@
+#include <array>
+#include <cstring>
+
+#include "crc32c.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define LSMT_CRC32C_SSE42
+#endif
+
+namespace LSMT {
+static constexpr uint32_t CRC32C_POLY = 0x82F63B78;  // 反转后的Castagnoli多项式
+
+// Slicing-by-8: 每次查8张表处理8字节
+static std::array<std::array<uint32_t, 256>, 8> make_table() {
+    std::array<std::array<uint32_t, 256>, 8> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; ++j) {
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+        }
+        table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t k = 1; k < 8; ++k) {
+            table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+        }
+    }
+    return table;
+}
+
+static const std::array<std::array<uint32_t, 256>, 8> CRC32C_TABLE = make_table();
+
+uint32_t crc32c_software(const void *data, size_t size, uint32_t crc) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    while (size >= 8) {
+        uint32_t low, high;
+        memcpy(&low, bytes, sizeof(uint32_t));
+        memcpy(&high, bytes + sizeof(uint32_t), sizeof(uint32_t));
+        low ^= crc;
+        crc = CRC32C_TABLE[7][low & 0xFF] ^ CRC32C_TABLE[6][(low >> 8) & 0xFF] ^
+              CRC32C_TABLE[5][(low >> 16) & 0xFF] ^ CRC32C_TABLE[4][low >> 24] ^
+              CRC32C_TABLE[3][high & 0xFF] ^ CRC32C_TABLE[2][(high >> 8) & 0xFF] ^
+              CRC32C_TABLE[1][(high >> 16) & 0xFF] ^ CRC32C_TABLE[0][high >> 24];
+        bytes += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ CRC32C_TABLE[0][(crc ^ *bytes++) & 0xFF];
+    }
+    return ~crc;
+}
+
+#ifdef LSMT_CRC32C_SSE42
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(const void *data, size_t size, uint32_t crc) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    uint64_t crc64 = ~crc;
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(uint64_t));
+        crc64 = _mm_crc32_u64(crc64, word);
+        bytes += 8;
+        size -= 8;
+    }
+    uint32_t crc32 = crc64;
+    while (size-- > 0) {
+        crc32 = _mm_crc32_u8(crc32, *bytes++);
+    }
+    return ~crc32;
+}
+#endif
+
+uint32_t crc32c(const void *data, size_t size, uint32_t crc) {
+#ifdef LSMT_CRC32C_SSE42
+    static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+    if (has_sse42) {
+        return crc32c_sse42(data, size, crc);
+    }
+#endif
+    return crc32c_software(data, size, crc);
+}
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LSMT {
+// CRC32C(Castagnoli) 校验和 x86-64平台在运行时检测SSE4.2并使用crc32指令
+// crc为之前数据的校验和 用于分段计算 crc32c(a + b) == crc32c(b, crc32c(a))
+uint32_t crc32c(const void *data, size_t size, uint32_t crc = 0);
+
+// 查表实现 不支持SSE4.2的平台使用 结果与硬件实现一致
+uint32_t crc32c_software(const void *data, size_t size, uint32_t crc = 0);
+} // LOG STRUCTURED MERGE TREE
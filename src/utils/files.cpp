@@ -94,7 +94,7 @@ uint64_t FileObj::read_uint64(size_t offset) {
     }
     auto buffer = file->read(offset, sizeof(uint64_t));
     return std::accumulate(buffer.begin(), buffer.end(), uint64_t{0},
-        [](uint32_t res, uint8_t val) { return (res << 8) | static_cast<uint64_t>(val); });
+        [](uint64_t res, uint8_t val) { return (res << 8) | static_cast<uint64_t>(val); });
 }
 
 bool FileObj::write(size_t offset, std::vector<uint8_t> &buffer) {
@@ -0,0 +1,163 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "filter.h"
+#include "bloom_filter.h"
+#include "blocked_bloom_filter.h"
+#include "binary_fuse_filter.h"
+#include "range_filter.h"
+
+namespace LSMT {
+FilterType to_filter_type(const std::string &name) {
+    if (name == "fuse") {
+        return FilterType::BINARY_FUSE;
+    } else {
+        return FilterType::BLOCKED_BLOOM;
+    }
+}
+
+std::shared_ptr<BaseFilter> BaseFilter::create(FilterType type, const std::vector<uint64_t> &hashes, double bits_per_key) {
+    if (type == FilterType::BINARY_FUSE) {
+        auto filter = std::make_shared<BinaryFuseFilter>();
+        if (BinaryFuseFilter::build(hashes, bits_per_key, *filter)) {
+            return filter;
+        }
+        type = FilterType::BLOCKED_BLOOM;  // 构建失败时回退到布隆过滤器
+    }
+    if (type == FilterType::BLOCKED_BLOOM) {
+        auto filter = std::make_shared<BlockedBloomFilter>(
+            BlockedBloomFilter::with_bits_per_key(hashes.size(), bits_per_key));
+        for (uint64_t hash : hashes) {
+            filter->add_hash(hash);
+        }
+        return filter;
+    }
+    throw std::runtime_error("Unsupported Filter Type " + std::to_string(static_cast<int>(type)));
+}
+
+std::vector<uint8_t> BaseFilter::encode_section(const std::shared_ptr<BaseFilter> &filter) {
+    FilterSection section;
+    section.key_filter = filter;
+    return section.encode();
+}
+
+std::shared_ptr<BaseFilter> BaseFilter::decode_section(const std::vector<uint8_t> &data) {
+    return FilterSection::decode(data).key_filter;
+}
+
+static void append_record(std::vector<uint8_t> &data, FilterRole role, const std::shared_ptr<BaseFilter> &filter) {
+    std::vector<uint8_t> filter_data = filter->encode();
+    uint32_t filter_size = filter_data.size();
+    data.push_back(static_cast<uint8_t>(role));
+    data.push_back(static_cast<uint8_t>(filter->get_type()));
+    data.insert(data.end(), reinterpret_cast<const uint8_t*>(&filter_size),
+                reinterpret_cast<const uint8_t*>(&filter_size) + sizeof(filter_size));
+    data.insert(data.end(), filter_data.begin(), filter_data.end());
+}
+
+static std::shared_ptr<BaseFilter> decode_filter(FilterType type, const uint8_t *filter_data, size_t filter_size) {
+    if (type == FilterType::BLOOM) {
+        return std::make_shared<BloomFilter>(BloomFilter::decode(filter_data, filter_size));
+    } else if (type == FilterType::BLOCKED_BLOOM) {
+        return std::make_shared<BlockedBloomFilter>(BlockedBloomFilter::decode(filter_data, filter_size));
+    } else if (type == FilterType::BINARY_FUSE) {
+        return std::make_shared<BinaryFuseFilter>(BinaryFuseFilter::decode(filter_data, filter_size));
+    } else if (type == FilterType::RANGE) {
+        return std::make_shared<RangeFilter>(RangeFilter::decode(filter_data, filter_size));
+    } else {
+        return nullptr;  // 未知类型的过滤器直接跳过 查询时不做过滤
+    }
+}
+
+std::vector<uint8_t> FilterSection::encode() const {
+    std::vector<uint8_t> data;
+    uint8_t record_number = (key_filter != nullptr ? 1 : 0) + (prefix_filter != nullptr ? 1 : 0) +
+                            (range_filter != nullptr ? 1 : 0);
+    if (record_number == 0) {
+        return data;
+    }
+
+    uint64_t magic = FILTER_MAGIC;
+    data.insert(data.end(), reinterpret_cast<const uint8_t*>(&magic),
+                reinterpret_cast<const uint8_t*>(&magic) + sizeof(magic));
+    data.push_back(FILTER_VERSION);
+    data.push_back(record_number);
+
+    std::string extractor = prefix_filter != nullptr ? prefix_extractor.substr(0, UINT8_MAX) : "";
+    data.push_back(static_cast<uint8_t>(extractor.size()));
+    data.insert(data.end(), extractor.begin(), extractor.end());
+
+    if (key_filter != nullptr) {
+        append_record(data, FilterRole::KEY, key_filter);
+    }
+    if (prefix_filter != nullptr) {
+        append_record(data, FilterRole::PREFIX, prefix_filter);
+    }
+    if (range_filter != nullptr) {
+        append_record(data, FilterRole::RANGE, range_filter);
+    }
+    return data;
+}
+
+FilterSection FilterSection::decode(const std::vector<uint8_t> &data) {
+    FilterSection section;
+    if (data.size() < sizeof(uint64_t)) {
+        throw std::runtime_error("Corrupted Filter Section");
+    }
+
+    uint64_t magic;
+    std::memcpy(&magic, data.data(), sizeof(magic));
+    if ((magic >> 48) == 0) {
+        section.key_filter = std::make_shared<BloomFilter>(BloomFilter::decode(data));
+        return section;
+    }
+    if (magic != FILTER_MAGIC || data.size() < sizeof(magic) + 2) {
+        throw std::runtime_error("Corrupted Filter Section");
+    }
+
+    size_t index = sizeof(magic);
+    uint8_t version = data[index++];
+    if (version > FILTER_VERSION) {
+        throw std::runtime_error("Unsupported Filter Version " + std::to_string(version));
+    }
+    uint8_t record_number = data[index++];
+
+    if (version >= 2) {
+        if (index >= data.size() || index + 1 + data[index] > data.size()) {
+            throw std::runtime_error("Corrupted Filter Section");
+        }
+        uint8_t extractor_size = data[index++];
+        section.prefix_extractor.assign(data.begin() + index, data.begin() + index + extractor_size);
+        index += extractor_size;
+    }
+
+    for (uint8_t i = 0; i < record_number; ++i) {
+        size_t header_size = (version >= 2 ? 2 : 1) + sizeof(uint32_t);
+        if (index + header_size > data.size()) {
+            throw std::runtime_error("Corrupted Filter Section");
+        }
+        auto role = version >= 2 ? static_cast<FilterRole>(data[index++]) : FilterRole::KEY;
+        auto type = static_cast<FilterType>(data[index++]);
+        uint32_t filter_size;
+        std::memcpy(&filter_size, &data[index], sizeof(filter_size));
+        index += sizeof(filter_size);
+        if (index + filter_size > data.size()) {
+            throw std::runtime_error("Corrupted Filter Section");
+        }
+
+        // 各过滤器直接从过滤器段缓冲区中解码 避免额外拷贝
+        const uint8_t *filter_data = data.data() + index;
+        index += filter_size;
+        if (role == FilterRole::KEY) {
+            section.key_filter = decode_filter(type, filter_data, filter_size);
+        } else if (role == FilterRole::PREFIX) {
+            section.prefix_filter = decode_filter(type, filter_data, filter_size);
+        } else if (role == FilterRole::RANGE) {
+            section.range_filter = std::dynamic_pointer_cast<RangeFilter>(decode_filter(type, filter_data, filter_size));
+        } else {
+            // 未知用途的过滤器直接跳过
+        }
+    }
+    return section;
+}
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/***
+---------------------------------------------------------------------------------------------------------------------
+|                                                 Filter Section                                                    |
+---------------------------------------------------------------------------------------------------------------------
+| Magic(8B) | Version(1B) | Record Numbers(1B) | Extractor Len(1B) | Extractor(Extractor Len) | Record 1 | ... | Record N |
+---------------------------------------------------------------------------------------------------------------------
+
+---------------------------------------------------------------------------
+|                               Record N                                  |
+---------------------------------------------------------------------------
+| Filter Role(1B) | Filter Type(1B) | Data Length(4B) | Data(Data Length) |
+---------------------------------------------------------------------------
+版本1没有Extractor字段 记录也没有Filter Role字段 全部视为键过滤器
+旧格式的过滤器段直接以BloomFilter编码开头 其首8字节bits_number的高16位恒为0 以此与Magic区分
+***/
+
+namespace LSMT {
+class RangeFilter;
+
+enum class FilterType : uint8_t {
+    BLOOM = 0,          // 旧版逐位布隆过滤器 仅用于读取旧文件
+    BLOCKED_BLOOM = 1,  // 缓存行分块布隆过滤器
+    BINARY_FUSE = 2,    // 静态异或过滤器 构建较慢但同等误判率下空间更小
+    RANGE = 3,          // 截断前缀范围过滤器 支持范围查询
+};
+
+enum class FilterRole : uint8_t {
+    KEY = 0,     // 完整键过滤器 用于点查询
+    PREFIX = 1,  // 前缀过滤器 记录前缀提取器作用后的结果 用于前缀扫描
+    RANGE = 2,   // 范围过滤器 用于判断某个键范围内是否可能存在键
+};
+
+FilterType to_filter_type(const std::string &name);
+
+class BaseFilter {
+public:
+    virtual ~BaseFilter() = default;
+
+    virtual void add(const std::string &key) = 0;
+
+    virtual bool possibly_contain(const std::string &key) const = 0;
+
+    virtual std::vector<uint8_t> encode() = 0;
+
+    virtual FilterType get_type() const = 0;
+
+    // 由所有键的64位哈希按每键位数构建指定类型的过滤器
+    static std::shared_ptr<BaseFilter> create(FilterType type, const std::vector<uint64_t> &hashes, double bits_per_key);
+
+    // 只包含键过滤器的过滤器段编解码
+    static std::vector<uint8_t> encode_section(const std::shared_ptr<BaseFilter> &filter);
+
+    static std::shared_ptr<BaseFilter> decode_section(const std::vector<uint8_t> &data);
+};
+
+struct FilterSection {
+    std::shared_ptr<BaseFilter> key_filter;
+    std::shared_ptr<BaseFilter> prefix_filter;
+    std::shared_ptr<RangeFilter> range_filter;
+    std::string prefix_extractor;  // 构建前缀过滤器时使用的前缀提取器描述
+
+    std::vector<uint8_t> encode() const;
+
+    static FilterSection decode(const std::vector<uint8_t> &data);
+
+    static constexpr uint64_t FILTER_MAGIC = 0x4c534d5446494c54ULL;  // "LSMTFILT"
+    static constexpr uint8_t FILTER_VERSION = 2;
+};
+} // LOG STRUCTURED MERGE TREE
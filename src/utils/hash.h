@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace LSMT {
+// 平台无关的64位哈希(MurmurHash64A) 结果会被持久化到SST中 不能使用实现相关的std::hash
+uint64_t murmur_hash64(const void *data, size_t len, uint64_t seed = 0);
+
+uint64_t murmur_hash64(const std::string &key, uint64_t seed = 0);
+} // LOG STRUCTURED MERGE TREE
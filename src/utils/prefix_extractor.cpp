@@ -0,0 +1,47 @@
+#include <cstdlib>
+
+#include "prefix_extractor.h"
+
+namespace LSMT {
+std::shared_ptr<PrefixExtractor> PrefixExtractor::create(const std::string &name) {
+    const std::string fixed = "fixed:";
+    const std::string delimiter = "delimiter:";
+    if (name.compare(0, fixed.size(), fixed) == 0) {
+        size_t length = std::strtoull(name.c_str() + fixed.size(), nullptr, 10);
+        if (length > 0) {
+            return std::make_shared<FixedPrefixExtractor>(length);
+        }
+    } else if (name.compare(0, delimiter.size(), delimiter) == 0 && name.size() == delimiter.size() + 1) {
+        return std::make_shared<DelimiterPrefixExtractor>(name.back());
+    }
+    return nullptr;
+}
+
+FixedPrefixExtractor::FixedPrefixExtractor(size_t length) : length(length) { }
+
+bool FixedPrefixExtractor::in_domain(const std::string &key) const {
+    return key.size() >= length;
+}
+
+std::string FixedPrefixExtractor::transform(const std::string &key) const {
+    return key.substr(0, length);
+}
+
+std::string FixedPrefixExtractor::get_name() const {
+    return "fixed:" + std::to_string(length);
+}
+
+DelimiterPrefixExtractor::DelimiterPrefixExtractor(char delimiter) : delimiter(delimiter) { }
+
+bool DelimiterPrefixExtractor::in_domain(const std::string &key) const {
+    return key.find(delimiter) != std::string::npos;
+}
+
+std::string DelimiterPrefixExtractor::transform(const std::string &key) const {
+    return key.substr(0, key.find(delimiter) + 1);
+}
+
+std::string DelimiterPrefixExtractor::get_name() const {
+    return std::string("delimiter:") + delimiter;
+}
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace LSMT {
+/***
+ * 前缀提取器: 对满足in_domain的查询前缀P 所有以P开头的键k都满足transform(k) == transform(P)
+ * 因此SST过滤器中记录transform(k)后 可以用transform(P)判断SST是否可能包含以P开头的键
+ * 描述格式: "none" | "fixed:N"(取前N个字节) | "delimiter:C"(取到第一个分隔符C为止 含分隔符)
+ ***/
+class PrefixExtractor {
+public:
+    virtual ~PrefixExtractor() = default;
+
+    virtual bool in_domain(const std::string &key) const = 0;
+
+    virtual std::string transform(const std::string &key) const = 0;
+
+    virtual std::string get_name() const = 0;
+
+    // 描述为none或无法解析时返回空指针
+    static std::shared_ptr<PrefixExtractor> create(const std::string &name);
+};
+
+class FixedPrefixExtractor : public PrefixExtractor {
+public:
+    FixedPrefixExtractor(size_t length);
+
+    bool in_domain(const std::string &key) const override;
+
+    std::string transform(const std::string &key) const override;
+
+    std::string get_name() const override;
+
+private:
+    size_t length;
+};
+
+class DelimiterPrefixExtractor : public PrefixExtractor {
+public:
+    DelimiterPrefixExtractor(char delimiter);
+
+    bool in_domain(const std::string &key) const override;
+
+    std::string transform(const std::string &key) const override;
+
+    std::string get_name() const override;
+
+private:
+    char delimiter;
+};
+} // LOG STRUCTURED MERGE TREE
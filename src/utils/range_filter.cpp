@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "range_filter.h"
+#include "utils/coding.h"
+
+namespace LSMT {
+RangeFilter::RangeFilter(size_t suffix_length)
+: suffix_length(static_cast<uint8_t>(std::min<size_t>(suffix_length, VARINT_FLAG - 1))), pending_lcp(0), has_pending(false) { }
+
+static size_t common_prefix_length(const std::string &lhs, const std::string &rhs) {
+    size_t length = std::min(lhs.size(), rhs.size());
+    size_t index = 0;
+    while (index < length && lhs[index] == rhs[index]) {
+        ++index;
+    }
+    return index;
+}
+
+void RangeFilter::add(const std::string &key) {
+    if (!has_pending) {
+        pending_key = key;
+        pending_lcp = 0;
+        has_pending = true;
+        return;
+    }
+    if (key == pending_key) {
+        return;
+    }
+    // 一个键的截断长度由它与前后两个相邻键的公共前缀共同决定
+    size_t lcp = common_prefix_length(pending_key, key);
+    append_entry(pending_key, std::max(pending_lcp, lcp));
+    pending_key = key;
+    pending_lcp = lcp;
+}
+
+void RangeFilter::append_entry(const std::string &key, size_t lcp) {
+    size_t length = lcp + 1 + suffix_length;
+    if (length >= key.size()) {
+        entries.push_back(key);
+        truncated.push_back(0);
+    } else {
+        entries.push_back(key.substr(0, length));
+        truncated.push_back(1);
+    }
+}
+
+void RangeFilter::finish() {
+    if (has_pending) {
+        append_entry(pending_key, pending_lcp);
+        pending_key.clear();
+        has_pending = false;
+    }
+}
+
+bool RangeFilter::possibly_contain(const std::string &key) const {
+    return may_contain(key, key);
+}
+
+bool RangeFilter::may_contain(const std::string &lower, const std::string &upper) const {
+    if (lower > upper) {
+        return false;
+    }
+    if (has_pending) {
+        return true;  // 尚未编码的过滤器不做判断
+    }
+    // 条目代表的键集合互不相交且有序 找到第一个上界不小于lower的条目
+    size_t left = 0;
+    size_t right = entries.size();
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        const std::string &entry = entries[mid];
+        bool below = entry < lower && !(truncated[mid] && lower.compare(0, entry.size(), entry) == 0);
+        if (below) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return left < entries.size() && entries[left] <= upper;
+}
+
+std::vector<uint8_t> RangeFilter::encode() {
+    finish();
+
+    std::vector<uint8_t> data;
+    data.push_back(suffix_length | VARINT_FLAG);
+    uint32_t entry_number = entries.size();
+    data.insert(data.end(), reinterpret_cast<const uint8_t*>(&entry_number),
+                reinterpret_cast<const uint8_t*>(&entry_number) + sizeof(entry_number));
+
+    const std::string *prev = nullptr;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const std::string &entry = entries[i];
+        size_t shared = prev == nullptr ? 0 : common_prefix_length(*prev, entry);
+        data.push_back(truncated[i]);
+        put_varint(data, shared);
+        put_varint(data, entry.size() - shared);
+        data.insert(data.end(), entry.begin() + shared, entry.end());
+        prev = &entry;
+    }
+    return data;
+}
+
+FilterType RangeFilter::get_type() const {
+    return FilterType::RANGE;
+}
+
+size_t RangeFilter::get_entry_number() const {
+    return entries.size() + (has_pending ? 1 : 0);
+}
+
+RangeFilter RangeFilter::decode(const std::vector<uint8_t> &data) {
+    return decode(data.data(), data.size());
+}
+
+RangeFilter RangeFilter::decode(const uint8_t *data, size_t size) {
+    if (size < 1 + sizeof(uint32_t)) {
+        throw std::runtime_error("Corrupted Range Filter");
+    }
+    bool is_varint = (data[0] & VARINT_FLAG) != 0;
+    RangeFilter filter(data[0] & (VARINT_FLAG - 1));
+    uint32_t entry_number;
+    std::memcpy(&entry_number, &data[1], sizeof(entry_number));
+    size_t index = 1 + sizeof(entry_number);
+
+    // 读取一个长度 旧格式为2字节
+    auto read_length = [data, size, is_varint, &index]() {
+        uint64_t length;
+        if (is_varint) {
+            const uint8_t *next = decode_varint(data + index, data + size, length);
+            if (next == nullptr) {
+                throw std::runtime_error("Corrupted Range Filter");
+            }
+            index = next - data;
+        } else {
+            if (index + sizeof(uint16_t) > size) {
+                throw std::runtime_error("Corrupted Range Filter");
+            }
+            uint16_t length16;
+            std::memcpy(&length16, &data[index], sizeof(uint16_t));
+            index += sizeof(uint16_t);
+            length = length16;
+        }
+        return length;
+    };
+
+    filter.entries.reserve(entry_number);
+    filter.truncated.reserve(entry_number);
+    for (uint32_t i = 0; i < entry_number; ++i) {
+        if (index >= size) {
+            throw std::runtime_error("Corrupted Range Filter");
+        }
+        uint8_t is_truncated = data[index++];
+        uint64_t shared = read_length();
+        uint64_t unshared = read_length();
+        if (unshared > size - index || (i == 0 ? shared != 0 : shared > filter.entries.back().size())) {
+            throw std::runtime_error("Corrupted Range Filter");
+        }
+
+        std::string entry = i == 0 ? std::string() : filter.entries.back().substr(0, shared);
+        entry.append(reinterpret_cast<const char*>(&data[index]), unshared);
+        index += unshared;
+        filter.entries.push_back(std::move(entry));
+        filter.truncated.push_back(is_truncated);
+    }
+    return filter;
+}
+} // LOG STRUCTURED MERGE TREE
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "filter.h"
+
+/***
+-------------------------------------------------------------------------
+|                             Range Filter                              |
+-------------------------------------------------------------------------
+| Suffix Length(1B) | Entry Numbers(4B) | Entry 1 | ... | Entry N       |
+-------------------------------------------------------------------------
+
+-----------------------------------------------------------------------------------------
+|                                        Entry N                                        |
+-----------------------------------------------------------------------------------------
+| Truncated(1B) | Shared Length(varint) | Unshared Length(varint) | Unshared(Unshared Length) |
+-----------------------------------------------------------------------------------------
+Suffix Length的最高位标记长度为varint 旧格式没有该标记 Shared Length和Unshared Length均为2字节
+参考SuRF: 每个键只保留区分它与相邻键所需的最短前缀 再附加Suffix Length字节的真实后缀
+截断后的前缀仍然有序 前缀p代表所有以p开头的键 完整保留的键只代表其自身
+条目相对前一个条目做前缀压缩 查询[lower, upper]时二分查找第一个可能不小于lower的条目
+***/
+
+namespace LSMT {
+class RangeFilter : public BaseFilter {
+public:
+    RangeFilter(size_t suffix_length = 1);
+
+    // 键必须按升序加入 重复的键会被忽略
+    void add(const std::string &key) override;
+
+    bool possibly_contain(const std::string &key) const override;
+
+    // 判断是否可能存在键位于[lower, upper]之间 返回false时该范围内一定没有键
+    bool may_contain(const std::string &lower, const std::string &upper) const;
+
+    std::vector<uint8_t> encode() override;
+
+    FilterType get_type() const override;
+
+    size_t get_entry_number() const;
+
+    static RangeFilter decode(const std::vector<uint8_t> &data);
+
+    static RangeFilter decode(const uint8_t *data, size_t size);
+
+private:
+    static constexpr uint8_t VARINT_FLAG = 0x80;
+
+    void finish();
+
+    void append_entry(const std::string &key, size_t lcp);
+
+private:
+    uint8_t suffix_length;
+    std::vector<std::string> entries;  // 截断后的键前缀 升序排列
+    std::vector<uint8_t> truncated;    // 对应条目是否被截断
+    std::string pending_key;           // 尚未确定截断长度的最后一个键
+    size_t pending_lcp;                // pending_key与前一个键的公共前缀长度
+    bool has_pending;
+};
+} // LOG STRUCTURED MERGE TREE
@@ -2,11 +2,15 @@
 #include <gmock/gmock.h>
 #include <iomanip>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "block/block.h"
 #include "block/block_cache.h"
+#include "block/clock_cache.h"
+#include "block/meta_cache.h"
 #include "block/block_meta.h"
+#include "block/learned_index.h"
 
 using namespace ::LSMT;
 
@@ -94,6 +98,28 @@ TEST_F(BlockTest, EncodeTest) {
     EXPECT_EQ(decoded->get_val_binary("orange", 1).value(), "orange1");
 }
 
+TEST_F(BlockTest, ChecksumTest) {
+    Block block(1024);
+    block.add_entry("apple", "red", 1, false);
+    block.add_entry("banana", "yellow", 2, false);
+
+    std::vector<uint8_t> encoded = block.encode();
+    encoded[3] ^= 0x01;
+    EXPECT_THROW(Block::decode(encoded), std::runtime_error);
+    EXPECT_NO_THROW(Block::decode(encoded, true, false));
+
+    // 旧版本写入的数据块使用std::hash校验 仍然可以读取
+    std::vector<uint8_t> legacy = block.encode(false);
+    uint32_t hash_value = std::hash<std::string_view>{}(
+        std::string_view(reinterpret_cast<const char*>(legacy.data()), legacy.size()));
+    legacy.resize(legacy.size() + sizeof(uint32_t));
+    memcpy(legacy.data() + legacy.size() - sizeof(uint32_t), &hash_value, sizeof(uint32_t));
+    auto decoded = Block::decode(legacy);
+    EXPECT_EQ(decoded->get_val_binary("banana", 0).value(), "yellow");
+    legacy[0] ^= 0x01;
+    EXPECT_THROW(Block::decode(legacy), std::runtime_error);
+}
+
 TEST_F(BlockTest, BinarySearchTest) {
     Block block(1024);
     block.add_entry("apple", "red", 0, false);
@@ -138,10 +164,79 @@ TEST_F(BlockTest, LargeDataTest) {
     }
 }
 
+TEST_F(BlockTest, LargeEntryTest) {
+    // 超过64KB的key和value以及超过64KB的数据块
+    std::string large_key(70000, 'k');
+    std::string large_val(200000, 'v');
+    for (size_t interval : {0, 16}) {
+        Block block(4096, interval);
+        block.set_hash_index(true);
+        EXPECT_TRUE(block.add_entry("a", "small", 1, false));
+        EXPECT_FALSE(block.add_entry(large_key, large_val, 2, false));
+        EXPECT_TRUE(block.add_entry(large_key, large_val, 2, true));
+        EXPECT_TRUE(block.add_entry(large_key + "z", "tail", 3, true));
+
+        auto decoded = Block::decode(block.encode());
+        EXPECT_GT(decoded->get_cur_size(), 1U << 16);
+        EXPECT_EQ(decoded->get_val_binary("a", 0), "small");
+        EXPECT_EQ(decoded->get_val_binary(large_key, 0), large_val);
+        EXPECT_EQ(decoded->get_val_binary(large_key + "z", 0), "tail");
+        EXPECT_EQ(decoded->get_key(1), large_key);
+    }
+}
+
+TEST_F(BlockTest, TrxIdDeltaTest) {
+    // 同一个块内事务id相近 差值编码后每个元素省去约7字节 基准之前的事务id编码为负差值
+    for (size_t interval : {0, 16}) {
+        Block plain_block(1 << 20, interval);
+        Block block(1 << 20, interval);
+        plain_block.set_hash_index(true);
+        block.set_trx_id_delta(true);
+        block.set_hash_index(true);
+        for (int i = 0; i < 1000; ++i) {
+            std::string key = "key" + std::to_string(10000 + i / 2);
+            uint64_t trx_id = 1000000 + (i % 2 == 0 ? i : -i);
+            EXPECT_TRUE(plain_block.add_entry(key, "v", trx_id, false));
+            EXPECT_TRUE(block.add_entry(key, "v", trx_id, false));
+        }
+        auto plain_encoded = plain_block.encode();
+        auto encoded = block.encode();
+        EXPECT_EQ(encoded.size(), block.get_cur_size() + sizeof(uint32_t));
+        EXPECT_LT(encoded.size() + 5 * 1000, plain_encoded.size());
+
+        auto decoded = Block::decode(encoded);
+        EXPECT_TRUE(decoded->has_trx_id_delta());
+        // 迭代器对每个key只返回最新版本
+        int i = 0;
+        for (auto it = decoded->begin(); it != decoded->end(); ++it, ++i) {
+            EXPECT_EQ(it->first, "key" + std::to_string(10000 + i));
+        }
+        EXPECT_EQ(i, 500);
+        // 按事务id过滤可见版本 每个key的较旧版本恰好在其事务id处可见
+        for (int j = 0; j < 500; j += 7) {
+            std::string key = "key" + std::to_string(10000 + j);
+            EXPECT_EQ(decoded->get_val_binary(key, 1000000 - 2 * j - 1), "v");
+            EXPECT_FALSE(decoded->get_val_binary(key, 1000000 - 2 * j - 2).has_value());
+        }
+    }
+
+    // 写入后不能再切换格式
+    Block block(4096);
+    block.add_entry("key", "val", 1, false);
+    EXPECT_THROW(block.set_trx_id_delta(true), std::runtime_error);
+}
+
 TEST_F(BlockTest, ErrorHandlingTest) {
     std::vector<uint8_t> error_data = {1}, empty_data;
     EXPECT_THROW(Block::decode(error_data), std::runtime_error);
     EXPECT_THROW(Block::decode(empty_data), std::runtime_error);
+
+    // 长度字段越界的数据块解码失败
+    Block block(4096);
+    block.add_entry("key", "val", 0, false);
+    auto encoded = block.encode(false);
+    encoded[0] = 0x7F;
+    EXPECT_THROW(Block::decode(encoded, false)->get_val_binary("key", 0), std::runtime_error);
 }
 
 TEST_F(BlockTest, IteratorTest1) {
@@ -199,6 +294,29 @@ TEST_F(BlockTest, IteratorTest2) {
     EXPECT_EQ(kvpairs, results);
 }
 
+TEST_F(BlockTest, IteratorViewTest) {
+    for (size_t restart_interval : {0, 3}) {
+        auto block = std::make_shared<Block>(4096, restart_interval);
+        block->add_entry("key1", "value11", 1, false);
+        block->add_entry("key2", "value23", 3, false);
+        block->add_entry("key2", "value22", 2, false);
+        block->add_entry("key22", "value221", 1, false);
+        block->add_entry("key3", "value31", 1, false);
+
+        std::vector<std::pair<std::string, std::string>> results;
+        for (auto it = block->begin(2); it != block->end(); ++it) {
+            results.emplace_back(it.key(), it.value());
+            EXPECT_EQ(it.key(), it->first);
+            EXPECT_EQ(it.value(), it->second);
+        }
+        std::vector<std::pair<std::string, std::string>> kvpairs = {
+            {"key1", "value11"}, {"key2", "value22"}, {"key22", "value221"}, {"key3", "value31"},
+        };
+        EXPECT_EQ(kvpairs, results);
+        EXPECT_THROW(block->end().key(), std::out_of_range);
+    }
+}
+
 TEST_F(BlockTest, PredicateTest1) {
     std::shared_ptr<Block> block = std::make_shared<Block>(4096);
     int number = 50;
@@ -254,6 +372,102 @@ TEST_F(BlockTest, PredicateTest2) {
     EXPECT_EQ(kvpairs, results);
 }
 
+TEST_F(BlockTest, PrefixCompressionTest) {
+    auto plain = std::make_shared<Block>(1024 * 32);
+    auto compressed = std::make_shared<Block>(1024 * 32, 4);
+    for (int i = 0; i < 200; ++i) {
+        std::string key = "tenant/table/" + std::to_string(1000 + i);
+        for (uint64_t trx_id = 3; trx_id > 0; --trx_id) {
+            plain->add_entry(key, "val" + std::to_string(i) + "_" + std::to_string(trx_id), trx_id, false);
+            compressed->add_entry(key, "val" + std::to_string(i) + "_" + std::to_string(trx_id), trx_id, false);
+        }
+    }
+    EXPECT_LT(compressed->get_cur_size() * 5, plain->get_cur_size() * 4);
+
+    // 同一个key的多个版本跨越重启点时 仍能按事务id找到正确版本
+    auto decoded = Block::decode(compressed->encode());
+    EXPECT_TRUE(decoded->is_prefix_compressed());
+    EXPECT_EQ(decoded->get_first_key(), "tenant/table/1000");
+    for (int i = 0; i < 200; ++i) {
+        std::string key = "tenant/table/" + std::to_string(1000 + i);
+        EXPECT_EQ(decoded->get_key(i * 3 + 2), key);
+        EXPECT_EQ(decoded->get_val_binary(key, 0).value(), "val" + std::to_string(i) + "_3");
+        EXPECT_EQ(decoded->get_val_binary(key, 1).value(), "val" + std::to_string(i) + "_1");
+        EXPECT_EQ(decoded->get_val_binary(key, 2).value(), "val" + std::to_string(i) + "_2");
+    }
+    EXPECT_FALSE(decoded->get_val_binary("tenant/table/0999", 0).has_value());
+    EXPECT_FALSE(decoded->get_val_binary("tenant/table/10005", 0).has_value());
+    EXPECT_FALSE(decoded->get_val_binary("tenant/table/2000", 0).has_value());
+
+    int count = 0;
+    for (auto it = decoded->begin(2); it != decoded->end(); ++it) {
+        EXPECT_EQ(it->first, "tenant/table/" + std::to_string(1000 + count));
+        EXPECT_EQ(it->second, "val" + std::to_string(count) + "_2");
+        ++count;
+    }
+    EXPECT_EQ(count, 200);
+
+    auto result = decoded->iters_preffix(0, "tenant/table/10");
+    ASSERT_TRUE(result.has_value());
+    auto [it_beg, it_end] = result.value();
+    EXPECT_EQ((*it_beg)->first, "tenant/table/1000");
+    EXPECT_EQ((*it_end)->first, "tenant/table/1100");
+
+    auto corrupted = compressed->encode(false);
+    corrupted[corrupted.size() - 3] ^= 0x7f;
+    EXPECT_THROW(Block::decode(corrupted, false), std::runtime_error);
+}
+
+TEST_F(BlockTest, HashIndexTest) {
+    // 旧格式和前缀压缩格式都可以附带哈希索引 点查询结果与二分查找一致
+    for (size_t restart_interval : {0, 4}) {
+        auto block = std::make_shared<Block>(1024 * 32, restart_interval);
+        block->set_hash_index(true);
+        for (int i = 0; i < 300; ++i) {
+            std::string key = "key" + std::to_string(1000 + i);
+            for (uint64_t trx_id = 3; trx_id > 0; --trx_id) {
+                block->add_entry(key, "val" + std::to_string(i) + "_" + std::to_string(trx_id), trx_id, false);
+            }
+        }
+        EXPECT_THROW(block->set_hash_index(false), std::runtime_error);
+        size_t cur_size = block->get_cur_size();
+        auto encoded = block->encode();
+        EXPECT_EQ(encoded.size(), cur_size + sizeof(uint32_t));
+
+        auto decoded = Block::decode(encoded);
+        EXPECT_TRUE(decoded->has_hash_index());
+        EXPECT_EQ(decoded->get_cur_size(), cur_size);
+        EXPECT_EQ(decoded->is_prefix_compressed(), restart_interval > 0);
+        for (int i = 0; i < 300; ++i) {
+            std::string key = "key" + std::to_string(1000 + i);
+            EXPECT_EQ(decoded->get_val_binary(key, 0).value(), "val" + std::to_string(i) + "_3");
+            EXPECT_EQ(decoded->get_val_binary(key, 1).value(), "val" + std::to_string(i) + "_1");
+            EXPECT_EQ(decoded->get_val_binary(key, 2).value(), "val" + std::to_string(i) + "_2");
+        }
+        for (int i = 0; i < 300; ++i) {
+            EXPECT_FALSE(decoded->get_val_binary("key" + std::to_string(2000 + i), 0).has_value());
+            EXPECT_FALSE(decoded->get_val_binary("key" + std::to_string(1000 + i) + "0", 0).has_value());
+        }
+
+        int count = 0;
+        for (auto it = decoded->begin(0); it != decoded->end(); ++it) {
+            EXPECT_EQ(it->first, "key" + std::to_string(1000 + count));
+            ++count;
+        }
+        EXPECT_EQ(count, 300);
+
+        auto corrupted = block->encode(false);
+        corrupted[corrupted.size() - 4] = 0xff;
+        corrupted[corrupted.size() - 3] = 0xff;
+        EXPECT_THROW(Block::decode(corrupted, false), std::runtime_error);
+    }
+
+    // 未开启哈希索引的块编码格式不变
+    auto plain = std::make_shared<Block>(1024 * 32);
+    plain->add_entry("key", "val", 1, false);
+    EXPECT_FALSE(Block::decode(plain->encode())->has_hash_index());
+}
+
 class BlockMetaTest : public ::testing::Test {
 protected:
     std::vector<BlockMeta> CreateTestMeta() {
@@ -342,11 +556,95 @@ TEST_F(BlockMetaTest, LargeMetaTest) {
         EXPECT_EQ(deocded[i].fkey, entries[i].fkey);
         EXPECT_EQ(deocded[i].lkey, entries[i].lkey);
     }
-    for (int i = 0; i < 1000; ++i) {
+    for (int i = 1; i < 1000; ++i) {
         EXPECT_LT(deocded[i - 1].lkey, deocded[i].fkey);
     }
 }
 
+TEST_F(BlockMetaTest, ShortSeparatorTest) {
+    EXPECT_EQ(BlockMeta::shortest_separator("abcdefg", "abzzz"), "abd");
+    EXPECT_EQ(BlockMeta::shortest_separator("abc", "abd"), "abc");        // 加1后等于limit 无法缩短
+    EXPECT_EQ(BlockMeta::shortest_separator("ab1999", "ab2000"), "ab1:");  // 只差1时在其后截断
+    EXPECT_EQ(BlockMeta::shortest_separator("abc", "abcdef"), "abc");     // start是limit的前缀
+    EXPECT_EQ(BlockMeta::shortest_separator(std::string("a\xff\x01", 3), "b"), std::string("a\xff\x01", 3));
+    EXPECT_EQ(BlockMeta::shortest_separator(std::string("\x01\x80xyz", 5), std::string("\x01\xf0", 2)),
+        std::string("\x01\x81", 2));
+
+    // 长key 每个数据块只保存一个短分隔符
+    std::vector<BlockMeta> entries;
+    for (int i = 0; i < 100; ++i) {
+        entries.emplace_back(i * 100, std::to_string(1000 + i * 10) + std::string(60, 'f'),
+            std::to_string(1000 + i * 10 + 5) + std::string(60, 'l'));
+    }
+    std::vector<uint8_t> full, shortened;
+    std::vector<BlockMeta> decoded;
+    BlockMeta::encode_meta(entries, full);
+    BlockMeta::encode_meta(entries, shortened, true);
+    EXPECT_LT(shortened.size() * 2, full.size());
+
+    BlockMeta::decode_meta(shortened, decoded);
+    ASSERT_EQ(decoded.size(), entries.size());
+    EXPECT_EQ(decoded.front().fkey, entries.front().fkey);
+    EXPECT_EQ(decoded.back().lkey, entries.back().lkey);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        EXPECT_EQ(decoded[i].offset, entries[i].offset);
+        EXPECT_GE(decoded[i].lkey, entries[i].lkey);
+        if (i + 1 < entries.size()) {
+            EXPECT_LT(decoded[i].lkey, entries[i + 1].fkey);
+            EXPECT_LT(decoded[i].lkey.size(), entries[i].lkey.size());
+        }
+        if (i > 0) {
+            EXPECT_TRUE(decoded[i].fkey.empty());
+        }
+    }
+
+    shortened[sizeof(uint32_t) + 2] ^= 1;
+    EXPECT_THROW(BlockMeta::decode_meta(shortened, decoded), std::runtime_error);
+}
+
+TEST(LearnedIndexTest, PredictWindow) {
+    // 按大端序编码的数值key 带公共前缀 数据块上界间距不均匀
+    auto make_key = [](uint64_t number) {
+        std::string key = "user:";
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            key.push_back(static_cast<char>(number >> shift));
+        }
+        return key;
+    };
+    std::vector<BlockMeta> entries;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        uint64_t base = i < 500 ? i * 100 : 50000 + (i - 500) * 1000;
+        entries.emplace_back(i * 4096, make_key(base), make_key(base + 50 + (i % 7) * 3));
+    }
+    EXPECT_EQ(LearnedIndex::build(entries, 0), nullptr);
+    EXPECT_EQ(LearnedIndex::build({entries[0], entries[1]}, 4), nullptr);
+
+    auto index = LearnedIndex::build(entries, 4);
+    ASSERT_NE(index, nullptr);
+    EXPECT_LE(index->get_segment_number(), 10U);
+    EXPECT_LE(index->get_max_error(), 8U);
+    auto encoded = index->encode();
+    auto decoded = LearnedIndex::decode(encoded.data(), encoded.size());
+    EXPECT_EQ(decoded->get_segment_number(), index->get_segment_number());
+
+    // 预测窗口包含第一个上界不小于key的数据块
+    for (uint64_t number = 0; number < 550000; number += 37) {
+        std::string key = make_key(number);
+        auto it = std::lower_bound(entries.begin(), entries.end(), key,
+            [](const BlockMeta &entry, const std::string &key) { return entry.lkey < key; });
+        size_t expected = std::min<size_t>(it - entries.begin(), entries.size() - 1);
+        auto [first, last] = index->predict(key);
+        EXPECT_LE(first, expected);
+        EXPECT_GT(last, expected);
+        EXPECT_LE(last - first, 2 * index->get_max_error() + 2);
+        EXPECT_EQ(decoded->predict(key), std::make_pair(first, last));
+    }
+
+    encoded[encoded.size() / 2] ^= 1;
+    EXPECT_THROW(LearnedIndex::decode(encoded.data(), encoded.size()), std::runtime_error);
+    EXPECT_THROW(LearnedIndex::decode(encoded.data(), 2), std::runtime_error);
+}
+
 class BlockCacheTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -427,6 +725,215 @@ TEST_F(BlockCacheTest, HitRate) {
     EXPECT_EQ(block_cache->hit_rate(), 2.0 / 3.0);
 }
 
+TEST_F(BlockCacheTest, PriorityFill) {
+    auto block1 = std::make_shared<Block>();
+    auto block2 = std::make_shared<Block>();
+    auto block3 = std::make_shared<Block>();
+    auto block4 = std::make_shared<Block>();
+
+    block_cache->put(1, 1, block1);
+    block_cache->put(1, 2, block2);
+    block_cache->put(1, 3, block3, CachePriority::LOW);
+    block_cache->put(1, 4, block4, CachePriority::BYPASS);
+
+    // BYPASS不插入缓存 LOW插入冷端最先被淘汰
+    EXPECT_EQ(block_cache->get(1, 4), nullptr);
+    block_cache->put(1, 4, block4);
+    EXPECT_EQ(block_cache->get(1, 3), nullptr);
+    EXPECT_EQ(block_cache->get(1, 1), block1);
+    EXPECT_EQ(block_cache->get(1, 2), block2);
+    EXPECT_EQ(block_cache->get(1, 4), block4);
+}
+
+TEST_F(BlockCacheTest, TinyLFUAdmission) {
+    BlockCache cache(3, 2, CacheAdmission::TINYLFU);
+    auto hot_block = std::make_shared<Block>();
+
+    for (int blk_id = 0; blk_id < 3; ++blk_id) {
+        cache.put(1, blk_id, hot_block);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(cache.get(1, blk_id), hot_block);
+        }
+    }
+
+    // 一次性扫描的冷数据块不能替换高频访问的数据块
+    for (int blk_id = 100; blk_id < 120; ++blk_id) {
+        EXPECT_EQ(cache.get(2, blk_id), nullptr);
+        cache.put(2, blk_id, std::make_shared<Block>());
+    }
+    for (int blk_id = 0; blk_id < 3; ++blk_id) {
+        EXPECT_EQ(cache.get(1, blk_id), hot_block);
+    }
+}
+
+TEST_F(BlockCacheTest, WarmPriority) {
+    BlockCache cache(3, 2, CacheAdmission::TINYLFU);
+    auto hot_block = std::make_shared<Block>();
+
+    for (int blk_id = 0; blk_id < 3; ++blk_id) {
+        cache.put(1, blk_id, hot_block);
+        cache.get(1, blk_id);
+    }
+
+    // 预热插入跳过准入检查 并可通过cached_blocks查询到
+    auto warm_block = std::make_shared<Block>();
+    cache.put(2, 0, warm_block, CachePriority::LOW);
+    EXPECT_EQ(cache.get(2, 0, CachePriority::LOW), nullptr);
+    cache.put(2, 0, warm_block, CachePriority::WARM);
+    EXPECT_EQ(cache.get(2, 0, CachePriority::LOW), warm_block);
+    EXPECT_EQ(cache.cached_blocks(2), std::vector<int>{0});
+    EXPECT_EQ(cache.cached_blocks(1).size(), 2);
+}
+
+TEST_F(BlockCacheTest, EraseSST) {
+    auto block1 = std::make_shared<Block>();
+    auto block2 = std::make_shared<Block>();
+    auto block3 = std::make_shared<Block>();
+
+    block_cache->put(1, 1, block1);
+    block_cache->put(2, 1, block2);
+    block_cache->put(1, 2, block3);
+    block_cache->get(1, 2);
+    block_cache->get(1, 2);
+
+    block_cache->erase_sst(1);
+    EXPECT_EQ(block_cache->get(1, 1), nullptr);
+    EXPECT_EQ(block_cache->get(1, 2), nullptr);
+    EXPECT_EQ(block_cache->get(2, 1), block2);
+
+    // 淘汰后释放的容量可以继续使用
+    block_cache->put(3, 1, block1);
+    block_cache->put(3, 2, block3);
+    EXPECT_EQ(block_cache->get(2, 1), block2);
+    EXPECT_EQ(block_cache->get(3, 1), block1);
+    EXPECT_EQ(block_cache->get(3, 2), block3);
+}
+
+TEST_F(BlockCacheTest, ZeroCapacity) {
+    // 块缓存容量全部预留给索引和过滤器时 任何优先级都不缓存数据块
+    for (auto admission : {CacheAdmission::NONE, CacheAdmission::TINYLFU}) {
+        BlockCache cache(0, 2, admission);
+        auto block = std::make_shared<Block>();
+        for (auto priority : {CachePriority::LOW, CachePriority::NORMAL, CachePriority::WARM}) {
+            cache.put(1, 1, block, priority);
+            EXPECT_EQ(cache.get(1, 1), nullptr);
+        }
+        EXPECT_TRUE(cache.cached_blocks(1).empty());
+    }
+}
+
+TEST(MetaCacheTest, EvictAndPin) {
+    MetaCache cache(100);
+    auto make_meta = [](size_t charge) {
+        auto meta = std::make_shared<SSTMeta>();
+        meta->charge = charge;
+        return meta;
+    };
+
+    auto pinned_meta = make_meta(40);
+    cache.put(1, pinned_meta, true);
+    cache.put(2, make_meta(30));
+    cache.put(3, make_meta(30));
+    EXPECT_EQ(cache.get_usage(), 100);
+    EXPECT_EQ(cache.get_pinned_usage(), 40);
+
+    // 超出容量时只淘汰最久未访问的非固定条目
+    EXPECT_NE(cache.get(2), nullptr);
+    cache.put(4, make_meta(30));
+    EXPECT_EQ(cache.get(1), pinned_meta);
+    EXPECT_NE(cache.get(2), nullptr);
+    EXPECT_EQ(cache.get(3), nullptr);
+    EXPECT_NE(cache.get(4), nullptr);
+    EXPECT_EQ(cache.get_usage(), 100);
+
+    cache.erase(1);
+    cache.erase(2);
+    EXPECT_EQ(cache.get(1), nullptr);
+    EXPECT_EQ(cache.get_usage(), 30);
+    EXPECT_EQ(cache.get_pinned_usage(), 0);
+}
+
+TEST(ClockCacheTest, PutAndGet) {
+    ClockCache cache(3);
+    auto block1 = std::make_shared<Block>();
+    auto block2 = std::make_shared<Block>();
+
+    cache.put(1, 1, block1);
+    cache.put(1, 2, block2);
+
+    EXPECT_EQ(cache.get(1, 1), block1);
+    EXPECT_EQ(cache.get(1, 2), block2);
+    EXPECT_EQ(cache.get(1, 3), nullptr);
+    EXPECT_EQ(cache.hit_rate(), 2.0 / 3.0);
+}
+
+TEST(ClockCacheTest, ClockEviction) {
+    ClockCache cache(3);
+    auto block1 = std::make_shared<Block>();
+    auto block2 = std::make_shared<Block>();
+    auto block3 = std::make_shared<Block>();
+    auto block4 = std::make_shared<Block>();
+    auto block5 = std::make_shared<Block>();
+
+    cache.put(1, 1, block1, CachePriority::LOW);
+    cache.put(1, 2, block2, CachePriority::LOW);
+    cache.put(1, 3, block3, CachePriority::LOW);
+
+    // 命中设置引用位 指针扫描时跳过被引用的槽位
+    cache.get(1, 2);
+    cache.put(1, 4, block4);
+    EXPECT_EQ(cache.get(1, 1), nullptr);
+
+    cache.put(1, 5, block5);
+    EXPECT_EQ(cache.get(1, 2), block2);
+    EXPECT_EQ(cache.get(1, 3), nullptr);
+    EXPECT_EQ(cache.get(1, 4), block4);
+    EXPECT_EQ(cache.get(1, 5), block5);
+}
+
+TEST(ClockCacheTest, EraseSST) {
+    ClockCache cache(3);
+    auto block1 = std::make_shared<Block>();
+    auto block2 = std::make_shared<Block>();
+    auto block3 = std::make_shared<Block>();
+
+    cache.put(1, 1, block1);
+    cache.put(2, 1, block2);
+    cache.put(1, 2, block3);
+
+    cache.erase_sst(1);
+    EXPECT_EQ(cache.get(1, 1), nullptr);
+    EXPECT_EQ(cache.get(1, 2), nullptr);
+    EXPECT_EQ(cache.get(2, 1), block2);
+
+    cache.put(3, 1, block1);
+    cache.put(3, 2, block3);
+    EXPECT_EQ(cache.get(2, 1), block2);
+    EXPECT_EQ(cache.get(3, 1), block1);
+    EXPECT_EQ(cache.get(3, 2), block3);
+}
+
+TEST(ClockCacheTest, ConcurrentAccess) {
+    ClockCache cache(64);
+    auto block = std::make_shared<Block>();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&cache, &block, t]() {
+            for (int i = 0; i < 10000; ++i) {
+                // 一半访问落在热点块上 其余循环扫描触发淘汰
+                int block_id = i % 2 == 0 ? i % 16 : (i * 7 + t) % 128;
+                if (cache.get(1, block_id) == nullptr) {
+                    cache.put(1, block_id, block);
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    EXPECT_GT(cache.hit_rate(), 0.0);
+}
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <fstream>
 #include <optional>
 #include <random>
 #include <unordered_map>
@@ -34,6 +35,31 @@ protected:
     bool no_clear = false;
 };
 
+TEST(LSMEngineTest, AllocateBitsPerKey) {
+    std::vector<double> level_sizes = {1, 4, 16, 64};
+    auto bits = LSMTEngine::allocate_bits_per_key(level_sizes, 10);
+
+    // 总内存与统一分配相同 越小的层分配越多位 各层误判率与层大小成正比
+    double total_bits = 0;
+    for (size_t level = 0; level < level_sizes.size(); ++level) {
+        total_bits += level_sizes[level] * bits[level];
+        if (level > 0) {
+            EXPECT_GT(bits[level - 1], bits[level]);
+        }
+    }
+    EXPECT_NEAR(total_bits, 10 * (1 + 4 + 16 + 64), 1e-3);
+
+    double ln2_square = std::pow(std::log(2), 2);
+    double p0 = std::exp(-bits[0] * ln2_square);
+    double p3 = std::exp(-bits[3] * ln2_square);
+    EXPECT_NEAR(p3 / p0, 64, 1e-3);
+
+    // 内存极少时最大层不分配过滤器
+    auto small_bits = LSMTEngine::allocate_bits_per_key(level_sizes, 0.5);
+    EXPECT_DOUBLE_EQ(small_bits[3], 0);
+    EXPECT_GT(small_bits[0], 0);
+}
+
 TEST_F(LSMTest, BasicOperations) {
     LSMTree lsm_tree(test_path);
 
@@ -162,6 +188,35 @@ TEST_F(LSMTest, Persistence) {
     }
 }
 
+TEST_F(LSMTest, SkipUnknownFiles) {
+    // 编号不是数字的文件不是引擎生成的SST或Blob文件 打开时跳过
+    for (const char *filename : {"blob_tmp", "sst_tmp.0", "sst_1.tmp"}) {
+        std::ofstream(test_path + "/" + filename) << "tmp";
+    }
+    LSMTEngine engine(test_path);
+    engine.put("key", "val", 0);
+    EXPECT_EQ(engine.get("key", 0)->first, "val");
+}
+
+TEST_F(LSMTest, LevelProperties) {
+    LSMTEngine engine(test_path);
+    for (int i = 0; i < 1000; ++i) {
+        engine.put("key" + std::to_string(1000 + i), "value" + std::to_string(i), 0);
+    }
+    for (int i = 0; i < 1000; i += 4) {
+        engine.remove("key" + std::to_string(1000 + i), 0);
+    }
+    engine.flush();
+
+    // 刷盘后不扫描数据块即可得到各层的数量估计
+    SSTProperties properties = engine.get_level_properties(0);
+    EXPECT_EQ(properties.key_number, 1000U);
+    EXPECT_EQ(properties.tombstone_number, 250U);
+    EXPECT_EQ(properties.raw_key_size, 1000U * 7);
+    EXPECT_GT(properties.data_size, 0U);
+    EXPECT_EQ(engine.get_level_properties(5).entry_number, 0U);
+}
+
 TEST_F(LSMTest, MonotonyPredicate) {
     LSMTree lsm_tree(test_path);
     std::set<std::string> expect_keys;
@@ -199,6 +254,52 @@ TEST_F(LSMTest, MonotonyPredicate) {
     EXPECT_EQ(expect_keys, actual_keys);
 }
 
+TEST_F(LSMTest, PreffixIteration) {
+    LSMTree lsm_tree(test_path);
+
+    for (int tenant = 0; tenant < 4; ++tenant) {
+        for (int i = 0; i < 50; ++i) {
+            lsm_tree.put("tenant" + std::to_string(tenant) + ":" + std::to_string(100 + i), std::to_string(i));
+        }
+        lsm_tree.flush_all();
+    }
+    lsm_tree.put("tenant2:999", "memtable");
+
+    auto result = lsm_tree.iters_preffix("tenant2:", 0);
+    ASSERT_TRUE(result.has_value());
+    std::vector<std::string> actual_keys;
+    auto [begin, end] = result.value();
+    for (auto it = begin; it != end; ++it) {
+        EXPECT_EQ(it->first.compare(0, 8, "tenant2:"), 0);
+        actual_keys.push_back(it->first);
+    }
+    EXPECT_EQ(actual_keys.size(), 51);
+    EXPECT_FALSE(lsm_tree.iters_preffix("tenant9:", 0).has_value());
+}
+
+TEST_F(LSMTest, RangeIteration) {
+    LSMTree lsm_tree(test_path);
+
+    for (int i = 0; i < 200; ++i) {
+        lsm_tree.put("key" + std::to_string(1000 + i * 2), std::to_string(i));
+    }
+    lsm_tree.flush_all();
+    lsm_tree.put("key1101", "memtable");
+
+    auto result = lsm_tree.iters_range("key1100", "key1110", 0);
+    ASSERT_TRUE(result.has_value());
+    std::vector<std::string> actual_keys;
+    auto [begin, end] = result.value();
+    for (auto it = begin; it != end; ++it) {
+        actual_keys.push_back(it->first);
+    }
+    std::vector<std::string> expected_keys = {"key1100", "key1101", "key1102", "key1104",
+                                              "key1106", "key1108", "key1110"};
+    EXPECT_EQ(actual_keys, expected_keys);
+    EXPECT_FALSE(lsm_tree.iters_range("key1111", "key1111", 0).has_value());
+    EXPECT_FALSE(lsm_tree.iters_range("key2", "key3", 0).has_value());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
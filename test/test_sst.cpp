@@ -114,6 +114,302 @@ TEST_F(SSTTest, ReopenSST) {
     EXPECT_EQ(sst->get_block_number(), new_sst->get_block_number());
 }
 
+TEST_F(SSTTest, CompressedBlocks) {
+    auto block_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+
+    SSTBuilder plain_builder(4096, true);
+    SSTBuilder builder(4096, true);
+    builder.set_compression(CompressionType::LZ4);
+    for (int i = 0; i < 2000; ++i) {
+        std::string key = "key" + std::to_string(100000 + i);
+        std::string val = "{\"id\":" + std::to_string(i) + ",\"status\":\"active\",\"tags\":[\"a\",\"b\"]}";
+        plain_builder.add(key, val, 0);
+        builder.add(key, val, 0);
+    }
+    auto plain_sst = plain_builder.build(1, "test_sst_path/test_sst_plain", block_cache);
+    auto sst = builder.build(2, "test_sst_path/test_sst_lz4", block_cache);
+    EXPECT_EQ(sst->get_block_number(), plain_sst->get_block_number());
+    EXPECT_LT(sst->get_sst_size() * 2, plain_sst->get_sst_size());
+
+    // 重新打开后从文件读取并解压数据块
+    auto new_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+    auto new_sst = SST::open(2, FileObj::open("test_sst_path/test_sst_lz4", false), new_cache);
+    for (int i = 0; i < 2000; i += 97) {
+        std::string key = "key" + std::to_string(100000 + i);
+        auto it = new_sst->get(key, 0);
+        ASSERT_TRUE(it.is_vld());
+        EXPECT_EQ(it->first, key);
+        EXPECT_EQ(it->second, "{\"id\":" + std::to_string(i) + ",\"status\":\"active\",\"tags\":[\"a\",\"b\"]}");
+    }
+    int count = 0;
+    for (auto it = new_sst->begin(0); it != new_sst->end(); ++it) {
+        ++count;
+    }
+    EXPECT_EQ(count, 2000);
+}
+
+TEST_F(SSTTest, FooterVersion) {
+    auto sst = create_test_sst(256, 100);
+    const SSTFooter &footer = sst->get_footer();
+    EXPECT_EQ(footer.version, SSTFooter::CURRENT_VERSION);
+    EXPECT_NE(footer.features & SST_FEATURE_PREFIX_COMPRESSION, 0U);
+
+    auto block_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+    auto new_sst = SST::open(1, FileObj::open("test_sst_path/test_sst0", false), block_cache);
+    EXPECT_EQ(new_sst->get_footer().features, footer.features);
+    EXPECT_EQ(new_sst->get_footer().meta_section_offset, footer.meta_section_offset);
+    EXPECT_EQ(new_sst->get_footer().filter_section_offset, footer.filter_section_offset);
+
+    // 版本1的文件按最初的格式逐字节写入: 数据块和Meta Section的长度均为2字节 校验值为std::hash
+    // 数据块没有压缩类型字节 文件末尾为四个大端序整数
+    auto append = [](std::vector<uint8_t> &buffer, const void *value, size_t size) {
+        buffer.insert(buffer.end(), static_cast<const uint8_t *>(value), static_cast<const uint8_t *>(value) + size);
+    };
+    auto append_hash = [&append](std::vector<uint8_t> &buffer, size_t begin) {
+        uint32_t hash_value = std::hash<std::string_view>{}(
+            std::string_view(reinterpret_cast<const char *>(buffer.data() + begin), buffer.size() - begin));
+        append(buffer, &hash_value, sizeof(uint32_t));
+    };
+    auto append_string = [&append](std::vector<uint8_t> &buffer, const std::string &str) {
+        uint16_t length = str.size();
+        append(buffer, &length, sizeof(uint16_t));
+        append(buffer, str.data(), str.size());
+    };
+    std::vector<uint8_t> data;
+    std::vector<BlockMeta> meta_entries;
+    for (int block_id = 0; block_id < 2; ++block_id) {
+        size_t block_offset = data.size();
+        std::vector<uint16_t> offsets;
+        for (int i = block_id * 5; i < block_id * 5 + 5; ++i) {
+            offsets.push_back(data.size() - block_offset);
+            append_string(data, "key" + std::to_string(i));
+            append_string(data, "val" + std::to_string(i));
+            uint64_t trx_id = 5;
+            append(data, &trx_id, sizeof(uint64_t));
+        }
+        append(data, offsets.data(), offsets.size() * sizeof(uint16_t));
+        uint16_t entry_number = offsets.size();
+        append(data, &entry_number, sizeof(uint16_t));
+        append_hash(data, block_offset);
+        meta_entries.emplace_back(block_offset, "key" + std::to_string(block_id * 5),
+            "key" + std::to_string(block_id * 5 + 4));
+    }
+    uint32_t meta_offset = data.size();
+    uint32_t meta_number = meta_entries.size();
+    append(data, &meta_number, sizeof(uint32_t));
+    for (const auto &entry : meta_entries) {
+        uint32_t offset32 = entry.offset;
+        append(data, &offset32, sizeof(uint32_t));
+        append_string(data, entry.fkey);
+        append_string(data, entry.lkey);
+    }
+    append_hash(data, meta_offset + sizeof(uint32_t));
+
+    FileObj legacy_file = FileObj::create_and_write("test_sst_path/test_sst_v1", data);
+    legacy_file.write_uint32(data.size(), meta_offset);
+    legacy_file.write_uint32(data.size() + sizeof(uint32_t), data.size());
+    legacy_file.write_uint64(data.size() + 2 * sizeof(uint32_t), 5);
+    legacy_file.write_uint64(data.size() + 2 * sizeof(uint32_t) + sizeof(uint64_t), 5);
+    legacy_file.sync();
+
+    auto legacy_sst = SST::open(2, FileObj::open("test_sst_path/test_sst_v1", false), block_cache);
+    EXPECT_EQ(legacy_sst->get_footer().version, 1U);
+    EXPECT_EQ(legacy_sst->get_properties(), nullptr);
+    EXPECT_EQ(legacy_sst->get_block_number(), 2);
+    EXPECT_EQ(legacy_sst->get_trx_id_range(), std::make_pair(uint64_t{5}, uint64_t{5}));
+    for (int i = 0; i < 10; ++i) {
+        auto it = legacy_sst->get("key" + std::to_string(i), 0);
+        ASSERT_TRUE(it.is_vld());
+        EXPECT_EQ(it->second, "val" + std::to_string(i));
+    }
+
+    // 只有V3_SIZE字节的文件按版本3读取 版本4的Footer不完整时拒绝打开
+    SSTFooter short_footer;
+    short_footer.version = 3;
+    std::vector<uint8_t> short_data = short_footer.encode();
+    short_data.erase(short_data.begin(), short_data.begin() + sizeof(uint64_t));
+    FileObj v3_file = FileObj::create_and_write("test_sst_path/test_sst_short_v3", short_data);
+    EXPECT_EQ(SSTFooter::read(v3_file).version, 3U);
+    uint32_t short_version = 4;
+    memcpy(short_data.data() + 4 * sizeof(uint64_t) + sizeof(uint32_t), &short_version, sizeof(uint32_t));
+    FileObj v4_file = FileObj::create_and_write("test_sst_path/test_sst_short_v4", short_data);
+    EXPECT_THROW(SSTFooter::read(v4_file), std::runtime_error);
+
+    // 未知版本拒绝打开
+    FileObj file = FileObj::open("test_sst_path/test_sst0", false);
+    size_t version_offset = file.size() - sizeof(uint64_t) - sizeof(uint32_t);
+    std::vector<uint8_t> version = {99, 0, 0, 0};
+    file.write(version_offset, version);
+    file.sync();
+    EXPECT_THROW(SST::open(3, FileObj::open("test_sst_path/test_sst0", false), block_cache), std::runtime_error);
+}
+
+TEST_F(SSTTest, Properties) {
+    auto block_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+
+    // 每个key两个版本 每10个key有一个删除标记
+    SSTBuilder builder(1024, true);
+    builder.set_compression(CompressionType::LZ4);
+    builder.set_index_partition_size(0);
+    for (int i = 0; i < 1000; ++i) {
+        std::string key = "key" + std::to_string(10000 + i);
+        builder.add(key, i % 10 == 0 ? "" : "value" + std::to_string(i), 2);
+        builder.add(key, "value" + std::to_string(i), 1);
+    }
+    auto sst = builder.build(1, "test_sst_path/test_sst_properties", block_cache);
+    const SSTProperties *properties = sst->get_properties();
+    ASSERT_NE(properties, nullptr);
+    EXPECT_EQ(properties->entry_number, 2000U);
+    EXPECT_EQ(properties->key_number, 1000U);
+    EXPECT_EQ(properties->tombstone_number, 100U);
+    EXPECT_DOUBLE_EQ(properties->get_tombstone_ratio(), 0.05);
+    EXPECT_EQ(properties->raw_key_size, 2000U * 8);
+    EXPECT_EQ(properties->get_block_number(), sst->get_block_number());
+    EXPECT_EQ(properties->data_size, sst->get_footer().meta_section_offset);
+    EXPECT_GT(properties->raw_data_size, properties->data_size);
+    EXPECT_GT(properties->creation_time, 0U);
+
+    // 重新打开后从统计信息段读取
+    auto new_sst = SST::open(1, FileObj::open("test_sst_path/test_sst_properties", false), block_cache);
+    const SSTProperties *new_properties = new_sst->get_properties();
+    ASSERT_NE(new_properties, nullptr);
+    EXPECT_EQ(new_properties->encode(), properties->encode());
+    EXPECT_EQ(new_sst->get("key10500", 0)->second, "");
+
+    // 版本3的文件没有统计信息段 Footer少8字节的Properties Offset
+    FileObj file = FileObj::open("test_sst_path/test_sst_properties", false);
+    std::vector<uint8_t> data = file.read(0, sst->get_footer().properties_offset);
+    std::vector<uint8_t> footer = file.read(file.size() - SSTFooter::V3_SIZE, SSTFooter::V3_SIZE);
+    uint32_t version = 3;
+    memcpy(footer.data() + 4 * sizeof(uint64_t) + sizeof(uint32_t), &version, sizeof(uint32_t));
+    data.insert(data.end(), footer.begin(), footer.end());
+    FileObj::create_and_write("test_sst_path/test_sst_v3", data).sync();
+    auto v3_sst = SST::open(2, FileObj::open("test_sst_path/test_sst_v3", false), block_cache);
+    EXPECT_EQ(v3_sst->get_footer().version, 3U);
+    EXPECT_EQ(v3_sst->get_properties(), nullptr);
+    EXPECT_EQ(v3_sst->get_block_number(), sst->get_block_number());
+    EXPECT_EQ(v3_sst->get("key10999", 0)->second, "value999");
+
+    // 统计信息段损坏时拒绝打开
+    std::vector<uint8_t> corrupted = {0xFF};
+    file.write(sst->get_footer().properties_offset, corrupted);
+    file.sync();
+    EXPECT_THROW(SST::open(3, FileObj::open("test_sst_path/test_sst_properties", false), block_cache),
+        std::runtime_error);
+}
+
+TEST_F(SSTTest, LargeValue) {
+    auto block_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+
+    // 超过数据块容量的值单独占用一个数据块 不会被丢弃
+    SSTBuilder builder(4096, true);
+    for (int i = 0; i < 10; ++i) {
+        std::string key = "key" + std::to_string(i);
+        builder.add(key, std::string(100000 + i, 'a' + i), 0);
+    }
+    builder.build(1, "test_sst_path/test_sst_large_value", block_cache);
+
+    auto sst = SST::open(1, FileObj::open("test_sst_path/test_sst_large_value", false), block_cache);
+    EXPECT_EQ(sst->get_block_number(), 10);
+    EXPECT_EQ(sst->get_footer().version, SSTFooter::CURRENT_VERSION);
+    for (int i = 0; i < 10; ++i) {
+        std::string key = "key" + std::to_string(i);
+        auto it = sst->get(key, 0);
+        ASSERT_TRUE(it.is_vld());
+        EXPECT_EQ(it->second, std::string(100000 + i, 'a' + i));
+    }
+}
+
+TEST_F(SSTTest, BlobSeparation) {
+    auto block_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+    auto blob_storage = std::make_shared<BlobStorage>("test_sst_path", 0.4);
+
+    // 不小于1024字节的值写入Blob文件
+    SSTBuilder builder(4096, true);
+    builder.set_blob_storage(blob_storage, 1024);
+    for (int i = 0; i < 100; ++i) {
+        std::string key = "key" + std::to_string(1000 + i);
+        builder.add(key, i % 2 == 0 ? std::string(2000 + i, 'a' + i % 26) : "val" + std::to_string(i), 0);
+    }
+    auto sst = builder.build(1, "test_sst_path/test_sst_blob", block_cache);
+    EXPECT_EQ(blob_storage->get_file_number(), 1U);
+    EXPECT_NE(sst->get_footer().features & SST_FEATURE_BLOB_INDEX, 0U);
+    EXPECT_LT(sst->get_sst_size(), 50 * 2000U);
+    blob_storage->add_references(sst->get_blob_refs());
+    EXPECT_DOUBLE_EQ(blob_storage->get_garbage_ratio(0), 0.0);
+
+    // 重新打开后扫描数据块恢复引用 读取时透明解析BlobIndex
+    auto new_sst = SST::open(1, FileObj::open("test_sst_path/test_sst_blob", false), block_cache);
+    EXPECT_EQ(new_sst->get_blob_refs(), sst->get_blob_refs());
+    EXPECT_THROW(new_sst->get("key1000", 0).get_val(), std::runtime_error);
+    new_sst->set_blob_storage(blob_storage);
+    for (int i = 0; i < 100; ++i) {
+        auto it = new_sst->get("key" + std::to_string(1000 + i), 0);
+        ASSERT_TRUE(it.is_vld());
+        EXPECT_EQ(it->second, i % 2 == 0 ? std::string(2000 + i, 'a' + i % 26) : "val" + std::to_string(i));
+    }
+
+    // 合并时BlobIndex原样写入新SST 值不再重写
+    SSTBuilder merge_builder(4096, true);
+    merge_builder.set_blob_storage(blob_storage, 1024);
+    int count = 0;
+    for (auto it = new_sst->begin(0, CachePriority::NORMAL, false); it != new_sst->end(); ++it) {
+        if (count++ % 4 == 0) {
+            continue;
+        }
+        if (it.is_blob_index()) {
+            merge_builder.add_blob_index(it->first, it->second, it.get_trx_id());
+        } else {
+            merge_builder.add(it->first, it->second, it.get_trx_id());
+        }
+    }
+    auto merged_sst = merge_builder.build(2, "test_sst_path/test_sst_blob_merged", block_cache);
+    EXPECT_EQ(blob_storage->get_file_number(), 1U);
+    blob_storage->add_references(merged_sst->get_blob_refs());
+    blob_storage->release_references(sst->get_blob_refs());
+    EXPECT_NEAR(blob_storage->get_garbage_ratio(0), 0.5, 0.05);
+    auto it = merged_sst->get("key1002", 0);
+    ASSERT_TRUE(it.is_vld());
+    EXPECT_EQ(it->second, std::string(2002, 'c'));
+
+    // 垃圾比例达到阈值后 合并把仍有效的值迁移到新文件 旧文件不再被引用时删除
+    SSTBuilder gc_builder(4096, true);
+    gc_builder.set_blob_storage(blob_storage, 1024);
+    for (auto it = merged_sst->begin(0, CachePriority::NORMAL, false); it != merged_sst->end(); ++it) {
+        if (it.is_blob_index()) {
+            gc_builder.add_blob_index(it->first, it->second, it.get_trx_id());
+        } else {
+            gc_builder.add(it->first, it->second, it.get_trx_id());
+        }
+    }
+    auto gc_sst = gc_builder.build(3, "test_sst_path/test_sst_blob_gc", block_cache);
+    EXPECT_EQ(blob_storage->get_file_number(), 2U);
+    blob_storage->add_references(gc_sst->get_blob_refs());
+    blob_storage->release_references(merged_sst->get_blob_refs());
+    EXPECT_EQ(blob_storage->get_file_number(), 1U);
+    EXPECT_FALSE(std::filesystem::exists(blob_storage->get_blob_path(0)));
+    EXPECT_DOUBLE_EQ(blob_storage->get_garbage_ratio(1), 0.0);
+    for (int i = 1; i < 100; ++i) {
+        auto it = gc_sst->get("key" + std::to_string(1000 + i), 0);
+        ASSERT_EQ(it.is_vld(), i % 4 != 0);
+        if (i % 4 != 0) {
+            EXPECT_EQ(it->second, i % 2 == 0 ? std::string(2000 + i, 'a' + i % 26) : "val" + std::to_string(i));
+        }
+    }
+}
+
 TEST_F(SSTTest, LargeSST) {
     SSTBuilder builder(4096, true);
     auto block_cache = std::make_shared<BlockCache>(
@@ -178,6 +474,356 @@ TEST_F(SSTTest, LargeSSTPredicate) {
     }
 }
 
+TEST_F(SSTTest, PartitionedIndex) {
+    auto block_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+
+    // 只保存偶数key 奇数key落在数据块之间或数据块内部都查不到
+    SSTBuilder builder(256, true);
+    builder.set_index_partition_size(512);
+    for (int i = 0; i < 4000; i += 2) {
+        builder.add("key" + std::to_string(10000 + i), "val" + std::to_string(i), 0);
+    }
+    auto sst = builder.build(1, "test_sst_path/test_sst_partitioned", block_cache);
+    EXPECT_NE(sst->get_footer().features & SST_FEATURE_PARTITIONED_INDEX, 0U);
+    EXPECT_GT(sst->get_block_number(), 100U);
+
+    auto new_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+    auto new_sst = SST::open(1, FileObj::open("test_sst_path/test_sst_partitioned", false), new_cache);
+    EXPECT_EQ(new_sst->get_block_number(), sst->get_block_number());
+    EXPECT_EQ(new_sst->get_fkey(), "key10000");
+    EXPECT_EQ(new_sst->get_lkey(), "key13998");
+    // 顶层索引远小于扁平索引
+    EXPECT_LT(new_sst->get_footer().filter_section_offset - new_sst->get_footer().meta_section_offset,
+        sst->get_block_number() * 8);
+
+    for (auto &table : {sst, new_sst}) {
+        for (int i = 0; i < 4000; ++i) {
+            auto it = table->get("key" + std::to_string(10000 + i), 0);
+            if (i % 2 == 0) {
+                ASSERT_TRUE(it.is_vld());
+                EXPECT_EQ(it->second, "val" + std::to_string(i));
+            } else {
+                EXPECT_FALSE(it.is_vld());
+            }
+        }
+        int count = 0;
+        for (auto it = table->begin(0); it != table->end(); ++it) {
+            EXPECT_EQ(it->first, "key" + std::to_string(10000 + count * 2));
+            ++count;
+        }
+        EXPECT_EQ(count, 2000);
+
+        auto result = table->iters_monotony_predicate(0, [](const std::string &key) {
+            return key.compare("key11001") < 0 ? 1 : (key.compare("key12999") > 0 ? -1 : 0);
+        });
+        ASSERT_TRUE(result.has_value());
+        auto [iter_beg, iter_end] = result.value();
+        EXPECT_EQ(iter_beg.get_key(), "key11002");
+        EXPECT_EQ(iter_end.get_key(), "key13000");
+    }
+
+    // 索引分区以负数编号放入块缓存
+    auto cached = new_cache->cached_blocks(1);
+    EXPECT_TRUE(std::any_of(cached.begin(), cached.end(), [](int block_id) { return block_id < 0; }));
+    EXPECT_EQ(new_sst->get_cached_ranges().size(),
+        std::count_if(cached.begin(), cached.end(), [](int block_id) { return block_id >= 0; }));
+}
+
+TEST_F(SSTTest, ShortSeparator) {
+    auto block_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+
+    // 长key只保存偶数 奇数key可能落在相邻数据块之间 需要读取数据块才能确定不存在
+    std::string suffix(80, 's');
+    auto make_key = [&suffix](int i) { return "user" + std::to_string(10000 + i) + suffix; };
+    for (size_t partition_size : {0, 512}) {
+        std::vector<std::shared_ptr<SST>> ssts;
+        std::vector<size_t> index_sizes;
+        for (bool shorten : {false, true}) {
+            SSTBuilder builder(1024, false);
+            builder.set_index_partition_size(partition_size);
+            builder.set_index_short_separator(shorten);
+            for (int i = 0; i < 2000; i += 2) {
+                builder.add(make_key(i), "val" + std::to_string(i), 0);
+            }
+            std::string path = "test_sst_path/test_sst_separator" + std::to_string(partition_size) +
+                (shorten ? "s" : "");
+            auto sst = builder.build(ssts.size(), path, block_cache);
+            EXPECT_EQ(sst->get_footer().features & SST_FEATURE_SHORT_SEPARATOR, shorten ? SST_FEATURE_SHORT_SEPARATOR : 0U);
+            EXPECT_EQ((sst->get_footer().features & SST_FEATURE_PARTITIONED_INDEX) != 0, partition_size > 0);
+            index_sizes.push_back(sst->get_footer().filter_section_offset - sst->get_properties()->data_size);
+            ssts.push_back(sst);
+            ssts.push_back(SST::open(ssts.size(), FileObj::open(path, false), block_cache));
+        }
+        // 索引(含分区)显著变小
+        EXPECT_LT(index_sizes[1] * 2, index_sizes[0]);
+
+        for (auto &sst : ssts) {
+            EXPECT_EQ(sst->get_fkey(), make_key(0));
+            EXPECT_EQ(sst->get_lkey(), make_key(1998));
+            for (int i = 0; i < 2000; ++i) {
+                auto it = sst->get(make_key(i), 0);
+                if (i % 2 == 0) {
+                    ASSERT_TRUE(it.is_vld());
+                    EXPECT_EQ(it->second, "val" + std::to_string(i));
+                } else {
+                    EXPECT_FALSE(it.is_vld());
+                }
+            }
+            auto result = sst->iters_monotony_predicate(0, [&make_key](const std::string &key) {
+                return key < make_key(501) ? 1 : (key > make_key(1499) ? -1 : 0);
+            });
+            ASSERT_TRUE(result.has_value());
+            auto [iter_beg, iter_end] = result.value();
+            EXPECT_EQ(iter_beg.get_key(), make_key(502));
+            EXPECT_EQ(iter_end.get_key(), make_key(1500));
+
+            // 缓存的键范围覆盖数据块中的所有key
+            auto block = sst->get_block(3);
+            auto ranges = sst->get_cached_ranges();
+            EXPECT_TRUE(std::any_of(ranges.begin(), ranges.end(), [&block](const auto &range) {
+                return range.first <= block->get_first_key() &&
+                       block->get_key(block->get_entry_number() - 1) <= range.second;
+            }));
+        }
+    }
+}
+
+TEST_F(SSTTest, LearnedIndex) {
+    auto block_cache = std::make_shared<BlockCache>(
+        TomlConfig::get_instance().get_lsm_block_cache_size(),
+        TomlConfig::get_instance().get_lsm_block_cache_lruk());
+
+    // 大端序编码的单调数值key 只保存偶数
+    auto make_key = [](uint64_t number) {
+        std::string key;
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            key.push_back(static_cast<char>(number >> shift));
+        }
+        return key;
+    };
+    std::vector<std::shared_ptr<SST>> ssts;
+    for (size_t error : {0, 4}) {
+        SSTBuilder builder(256, false);
+        builder.set_index_partition_size(0);
+        builder.set_learned_index_error(error);
+        for (uint64_t i = 0; i < 20000; i += 2) {
+            builder.add(make_key(1000000 + i), "val" + std::to_string(i), 0);
+        }
+        std::string path = "test_sst_path/test_sst_learned" + std::to_string(error);
+        auto sst = builder.build(ssts.size(), path, block_cache);
+        EXPECT_EQ((sst->get_footer().features & SST_FEATURE_LEARNED_INDEX) != 0, error > 0);
+        ssts.push_back(sst);
+        ssts.push_back(SST::open(ssts.size(), FileObj::open(path, false), block_cache));
+    }
+    EXPECT_GT(ssts[0]->get_block_number(), 100U);
+
+    for (auto &sst : ssts) {
+        for (uint64_t i = 0; i < 20000; ++i) {
+            std::string key = make_key(1000000 + i);
+            EXPECT_EQ(sst->get_block_id(key), ssts[0]->get_block_id(key));
+            auto it = sst->get(key, 0);
+            if (i % 2 == 0) {
+                ASSERT_TRUE(it.is_vld());
+                EXPECT_EQ(it->second, "val" + std::to_string(i));
+            } else {
+                EXPECT_FALSE(it.is_vld());
+            }
+        }
+        EXPECT_EQ(sst->get_block_id(make_key(999999)), -1);
+        EXPECT_EQ(sst->get_block_id(make_key(1020000)), -1);
+    }
+}
+
+TEST_F(SSTTest, PrepopulateAll) {
+    SSTBuilder builder(256, true);
+    auto block_cache = std::make_shared<BlockCache>(1024, 2);
+    builder.set_prepopulate(CachePrepopulate::ALL, block_cache);
+
+    for (int i = 0; i < 200; i++) {
+        builder.add("key" + std::to_string(1000 + i), "val" + std::to_string(i), 0);
+    }
+    auto sst = builder.build(1, "test_sst_path/test_sst6", block_cache);
+
+    // 构建完成后所有数据块已在缓存中 读取不会产生未命中
+    EXPECT_GT(sst->get_block_number(), 1);
+    EXPECT_EQ(block_cache->cached_blocks(1).size(), sst->get_block_number());
+    for (size_t i = 0; i < sst->get_block_number(); ++i) {
+        EXPECT_TRUE(sst->get_block(i) != nullptr);
+    }
+    EXPECT_DOUBLE_EQ(block_cache->hit_rate(), 1.0);
+}
+
+TEST_F(SSTTest, PrepopulateAllFreeCapacity) {
+    auto block_cache = std::make_shared<BlockCache>(4, 2);
+    SSTBuilder old_builder(256, true);
+    for (int i = 0; i < 200; i++) {
+        old_builder.add("key" + std::to_string(1000 + i), "val" + std::to_string(i), 0);
+    }
+    auto old_sst = old_builder.build(1, "test_sst_path/test_sst6", block_cache);
+    old_sst->get_block(0);
+    old_sst->get_block(1);
+
+    SSTBuilder builder(256, true);
+    builder.set_prepopulate(CachePrepopulate::ALL, block_cache);
+    for (int i = 0; i < 200; i++) {
+        builder.add("key" + std::to_string(1000 + i), "new" + std::to_string(i), 1);
+    }
+    auto sst = builder.build(2, "test_sst_path/test_sst7", block_cache);
+
+    // 只填充剩余的空闲容量 已缓存的数据块不被淘汰
+    EXPECT_EQ(block_cache->get_usage(), block_cache->get_capacity());
+    EXPECT_EQ(block_cache->cached_blocks(1).size(), 2);
+    EXPECT_EQ(block_cache->cached_blocks(2).size(), 2);
+}
+
+TEST_F(SSTTest, PrepopulateHot) {
+    auto block_cache = std::make_shared<BlockCache>(1024, 2);
+
+    // 旧SST只有读取过的数据块在缓存中 其键范围即为热点范围
+    SSTBuilder old_builder(256, true);
+    for (int i = 0; i < 200; i++) {
+        old_builder.add("key" + std::to_string(1000 + i), "val" + std::to_string(i), 0);
+    }
+    auto old_sst = old_builder.build(1, "test_sst_path/test_sst7", block_cache);
+    EXPECT_TRUE(old_sst->get_cached_ranges().empty());
+    old_sst->get_block(2);
+    auto hot_ranges = old_sst->get_cached_ranges();
+    ASSERT_EQ(hot_ranges.size(), 1);
+
+    SSTBuilder builder(256, true);
+    builder.set_prepopulate(CachePrepopulate::HOT, block_cache, hot_ranges);
+    for (int i = 0; i < 200; i++) {
+        builder.add("key" + std::to_string(1000 + i), "new" + std::to_string(i), 1);
+    }
+    auto sst = builder.build(2, "test_sst_path/test_sst8", block_cache);
+
+    // 只有与热点范围重叠的数据块被预热
+    auto cached_ranges = sst->get_cached_ranges();
+    EXPECT_FALSE(cached_ranges.empty());
+    EXPECT_LT(cached_ranges.size(), sst->get_block_number());
+    for (auto &[fkey, lkey] : cached_ranges) {
+        EXPECT_TRUE(fkey <= hot_ranges[0].second && lkey >= hot_ranges[0].first);
+    }
+}
+
+TEST_F(SSTTest, CacheIndexAndFilter) {
+    auto block_cache = std::make_shared<BlockCache>(1024, 2);
+    auto meta_cache = std::make_shared<MetaCache>(1);
+
+    std::vector<std::shared_ptr<SST>> ssts;
+    for (int sst_id = 0; sst_id < 3; ++sst_id) {
+        SSTBuilder builder(256, true);
+        for (int i = 0; i < 100; i++) {
+            builder.add("key" + std::to_string(1000 + i), "val" + std::to_string(sst_id), 0);
+        }
+        auto sst = builder.build(sst_id, "test_sst_path/test_meta" + std::to_string(sst_id), block_cache);
+        sst->set_meta_cache(meta_cache, sst_id == 0);
+        ssts.push_back(sst);
+    }
+
+    // 容量不足时非固定SST的索引和过滤器被淘汰 查询时从文件重新加载
+    EXPECT_EQ(meta_cache->get(1), nullptr);
+    for (int sst_id = 0; sst_id < 3; ++sst_id) {
+        auto iter = ssts[sst_id]->get("key1050", 0);
+        ASSERT_TRUE(iter.is_vld());
+        EXPECT_EQ(iter.get_val(), "val" + std::to_string(sst_id));
+        EXPECT_FALSE(ssts[sst_id]->get("key2000", 0).is_vld());
+    }
+    EXPECT_NE(meta_cache->get(0), nullptr);
+    EXPECT_GT(meta_cache->get_pinned_usage(), 0);
+
+    ssts[0]->remove();
+    EXPECT_EQ(meta_cache->get_pinned_usage(), 0);
+}
+
+TEST_F(SSTTest, FilterSizedByKeyNumber) {
+    auto block_cache = std::make_shared<BlockCache>(16, 2);
+
+    // 过滤器按实际键数量分配 大SST的误判率不会随键数量增长而失控
+    SSTBuilder large_builder(4096, true);
+    for (int i = 0; i < 200000; i++) {
+        large_builder.add("key" + std::to_string(1000000 + i), "v", 0);
+    }
+    auto large_sst = large_builder.build(1, "test_sst_path/test_filter1", block_cache);
+
+    int false_positive = 0;
+    for (int i = 0; i < 10000; i++) {
+        if (large_sst->get_block_id("key" + std::to_string(1000000 + i) + "x") != -1) {
+            false_positive++;
+        }
+    }
+    EXPECT_LE(false_positive, 300);
+
+    // 小SST的过滤器不再固定占用大块空间
+    SSTBuilder small_builder(4096, true);
+    small_builder.add("key", "val", 0);
+    auto small_sst = small_builder.build(2, "test_sst_path/test_filter2", block_cache);
+    EXPECT_LT(small_sst->get_sst_size(), 1024);
+}
+
+TEST_F(SSTTest, PreffixFilter) {
+    auto block_cache = std::make_shared<BlockCache>(16, 2);
+    auto extractor = PrefixExtractor::create("delimiter::");
+    ASSERT_NE(extractor, nullptr);
+
+    SSTBuilder builder(256, true);
+    builder.set_prefix_extractor(extractor);
+    for (int tenant = 10; tenant < 90; tenant += 2) {
+        for (int i = 0; i < 10; ++i) {
+            builder.add("tenant" + std::to_string(tenant) + ":" + std::to_string(i), "val", 0);
+        }
+    }
+    builder.build(1, "test_sst_path/test_preffix", block_cache);
+    auto sst = SST::open(1, FileObj::open("test_sst_path/test_preffix", false), block_cache);
+
+    // 奇数租户不在SST中 虽然位于键范围内也应被前缀过滤器排除
+    int false_positive = 0;
+    for (int tenant = 10; tenant < 90; ++tenant) {
+        bool result = sst->may_contain_preffix("tenant" + std::to_string(tenant) + ":", extractor);
+        if (tenant % 2 == 0) {
+            EXPECT_TRUE(result);
+            EXPECT_TRUE(sst->may_contain_preffix("tenant" + std::to_string(tenant) + ":1", extractor));
+        } else {
+            false_positive += result ? 1 : 0;
+        }
+    }
+    EXPECT_LE(false_positive, 4);
+
+    // 超出键范围或不在提取器定义域内的前缀
+    EXPECT_FALSE(sst->may_contain_preffix("tenant9", extractor));
+    EXPECT_TRUE(sst->may_contain_preffix("tenant1", extractor));
+    EXPECT_TRUE(sst->may_contain_preffix("tenant11:", nullptr));
+    EXPECT_TRUE(sst->may_contain_preffix("tenant11:", PrefixExtractor::create("fixed:8")));
+}
+
+TEST_F(SSTTest, RangeFilter) {
+    auto block_cache = std::make_shared<BlockCache>(16, 2);
+
+    SSTBuilder builder(256, true);
+    builder.set_range_filter(true);
+    for (int i = 1000; i < 3000; i += 10) {
+        builder.add("key" + std::to_string(i), "val", 0);
+    }
+    builder.build(1, "test_sst_path/test_range", block_cache);
+    auto sst = SST::open(1, FileObj::open("test_sst_path/test_range", false), block_cache);
+
+    EXPECT_TRUE(sst->may_contain_range("key1000", "key1000"));
+    EXPECT_TRUE(sst->may_contain_range("key1001", "key1010"));
+    EXPECT_TRUE(sst->may_contain_range("key0", "key1000"));
+    // 位于键范围内但没有键的短范围
+    EXPECT_FALSE(sst->may_contain_range("key1001", "key1009"));
+    EXPECT_FALSE(sst->may_contain_range("key2991", "key2999"));
+    // 与键范围不相交的范围
+    EXPECT_FALSE(sst->may_contain_range("key3", "key4"));
+    EXPECT_FALSE(sst->may_contain_range("a", "b"));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
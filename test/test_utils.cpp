@@ -1,10 +1,20 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <algorithm>
 #include <filesystem>
 #include <random>
 
 #include "config/config.h"
+#include "utils/binary_fuse_filter.h"
+#include "utils/blocked_bloom_filter.h"
+#include "utils/coding.h"
+#include "utils/compression.h"
+#include "utils/crc32c.h"
 #include "utils/bloom_filter.h"
+#include "utils/hash.h"
+#include "utils/prefix_extractor.h"
+#include "utils/range_filter.h"
+#include "utils/count_min_sketch.h"
 #include "utils/files.h"
 
 using namespace ::LSMT;
@@ -101,6 +111,15 @@ TEST_F(FileTest, ErrorCases) {
     EXPECT_THROW(FileObj::open("nonexistent.dat", false), std::runtime_error);
 }
 
+TEST_F(FileTest, ReadUint64) {
+    // 大端序读取 高32位不能丢失
+    const std::string path = "test_dir/uint64.dat";
+    std::vector<uint8_t> data = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+
+    auto file = FileObj::create_and_write(path, data);
+    EXPECT_EQ(file.read_uint64(0), 0x0123456789ABCDEFULL);
+}
+
 TEST(BloomFilterTest, BloomFilterOperation) {
     BloomFilter filter(1000, 0.1);
 
@@ -121,6 +140,335 @@ TEST(BloomFilterTest, BloomFilterOperation) {
     }
     double false_positive_rate = static_cast<double>(false_positive) / 1000;
     EXPECT_LE(false_positive_rate, 0.2) << "False positive rate " << false_positive_rate;
+
+    // 解码后的位数组与编码前逐字节一致
+    auto data = filter.encode();
+    auto decoded = BloomFilter::decode(data);
+    EXPECT_EQ(decoded.encode(), data);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(decoded.possibly_contain("bloom_filter" + std::to_string(i)));
+    }
+    data.resize(data.size() - 1);
+    EXPECT_THROW(BloomFilter::decode(data), std::runtime_error);
+}
+
+TEST(BloomFilterTest, BlockedBloomFilterOperation) {
+    BlockedBloomFilter filter(1000, 0.01);
+
+    for (int i = 0; i < 1000; ++i) {
+        filter.add("bloom_filter" + std::to_string(i));
+    }
+
+    auto decoded = BlockedBloomFilter::decode(filter.encode());
+    int false_positive = 0;
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(filter.possibly_contain("bloom_filter" + std::to_string(i)));
+        EXPECT_TRUE(decoded.possibly_contain("bloom_filter" + std::to_string(i)));
+    }
+    for (int i = 1000; i < 11000; ++i) {
+        if (decoded.possibly_contain("key" + std::to_string(i))) {
+            false_positive++;
+        }
+    }
+    double false_positive_rate = static_cast<double>(false_positive) / 10000;
+    EXPECT_LE(false_positive_rate, 0.03) << "False positive rate " << false_positive_rate;
+}
+
+TEST(BloomFilterTest, FilterSectionVersion) {
+    // 新格式带有Magic和类型标签 旧格式的过滤器段仍可解码
+    auto blocked = std::make_shared<BlockedBloomFilter>(100, 0.1);
+    auto legacy = std::make_shared<BloomFilter>(100, 0.1);
+    for (int i = 0; i < 100; ++i) {
+        blocked->add("key" + std::to_string(i));
+        legacy->add("key" + std::to_string(i));
+    }
+
+    auto blocked_decoded = BaseFilter::decode_section(BaseFilter::encode_section(blocked));
+    auto legacy_decoded = BaseFilter::decode_section(legacy->encode());
+    ASSERT_NE(blocked_decoded, nullptr);
+    ASSERT_NE(legacy_decoded, nullptr);
+    EXPECT_EQ(blocked_decoded->get_type(), FilterType::BLOCKED_BLOOM);
+    EXPECT_EQ(legacy_decoded->get_type(), FilterType::BLOOM);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(blocked_decoded->possibly_contain("key" + std::to_string(i)));
+        EXPECT_TRUE(legacy_decoded->possibly_contain("key" + std::to_string(i)));
+    }
+
+    std::vector<uint8_t> corrupted = BaseFilter::encode_section(blocked);
+    corrupted.resize(corrupted.size() / 2);
+    EXPECT_THROW(BaseFilter::decode_section(corrupted), std::runtime_error);
+}
+
+TEST(BloomFilterTest, BinaryFuseFilterOperation) {
+    std::vector<uint64_t> hashes;
+    for (int i = 0; i < 10000; ++i) {
+        hashes.push_back(murmur_hash64("fuse_filter" + std::to_string(i)));
+    }
+    auto fuse = BaseFilter::create(FilterType::BINARY_FUSE, hashes, 9);
+    auto bloom = BaseFilter::create(FilterType::BLOCKED_BLOOM, hashes, 9);
+    ASSERT_EQ(fuse->get_type(), FilterType::BINARY_FUSE);
+
+    auto decoded = BaseFilter::decode_section(BaseFilter::encode_section(fuse));
+    ASSERT_EQ(decoded->get_type(), FilterType::BINARY_FUSE);
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(decoded->possibly_contain("fuse_filter" + std::to_string(i)));
+    }
+
+    // 相同空间下误判率明显低于布隆过滤器
+    int fuse_false_positive = 0;
+    int bloom_false_positive = 0;
+    for (int i = 0; i < 100000; ++i) {
+        std::string key = "key" + std::to_string(i);
+        fuse_false_positive += decoded->possibly_contain(key) ? 1 : 0;
+        bloom_false_positive += bloom->possibly_contain(key) ? 1 : 0;
+    }
+    EXPECT_LE(fuse->encode().size(), bloom->encode().size() * 11 / 10);
+    EXPECT_LT(fuse_false_positive * 2, bloom_false_positive);
+
+    // 分段参数与数组长度不一致的过滤器拒绝解码
+    std::vector<uint8_t> encoded = fuse->encode();
+    EXPECT_NO_THROW(BinaryFuseFilter::decode(encoded));
+    size_t segment_length_offset = sizeof(uint64_t);
+    size_t segment_count_offset = segment_length_offset + sizeof(uint32_t);
+    for (auto [offset, value] : {std::make_pair(segment_length_offset, 0U), std::make_pair(segment_count_offset, 0U),
+                                 std::make_pair(segment_count_offset, 1U << 20)}) {
+        std::vector<uint8_t> corrupted = encoded;
+        std::memcpy(corrupted.data() + offset, &value, sizeof(uint32_t));
+        EXPECT_THROW(BinaryFuseFilter::decode(corrupted), std::runtime_error);
+    }
+
+    // 极少量键也能正确构建
+    for (size_t number = 0; number < 4; ++number) {
+        std::vector<uint64_t> few(hashes.begin(), hashes.begin() + number);
+        auto filter = BaseFilter::create(FilterType::BINARY_FUSE, few, 10);
+        for (size_t i = 0; i < number; ++i) {
+            EXPECT_TRUE(filter->possibly_contain("fuse_filter" + std::to_string(i)));
+        }
+    }
+}
+
+TEST(PrefixExtractorTest, PrefixExtractorOperation) {
+    EXPECT_EQ(PrefixExtractor::create("none"), nullptr);
+    EXPECT_EQ(PrefixExtractor::create("fixed:0"), nullptr);
+
+    auto fixed = PrefixExtractor::create("fixed:4");
+    ASSERT_NE(fixed, nullptr);
+    EXPECT_EQ(fixed->get_name(), "fixed:4");
+    EXPECT_FALSE(fixed->in_domain("abc"));
+    EXPECT_EQ(fixed->transform("abcdef"), "abcd");
+
+    auto delimiter = PrefixExtractor::create("delimiter:/");
+    ASSERT_NE(delimiter, nullptr);
+    EXPECT_EQ(delimiter->get_name(), "delimiter:/");
+    EXPECT_FALSE(delimiter->in_domain("tenant"));
+    EXPECT_EQ(delimiter->transform("tenant/a/b"), "tenant/");
+}
+
+TEST(RangeFilterTest, RangeFilterOperation) {
+    RangeFilter filter;
+    std::vector<std::string> keys = {"apple", "apricot", "banana", "band", "bandana", "cherry"};
+    for (const auto &key : keys) {
+        filter.add(key);
+        filter.add(key);
+    }
+    auto decoded = RangeFilter::decode(filter.encode());
+    EXPECT_EQ(decoded.get_entry_number(), keys.size());
+
+    for (const auto &key : keys) {
+        EXPECT_TRUE(decoded.possibly_contain(key));
+    }
+    EXPECT_TRUE(decoded.may_contain("bana", "banb"));
+    EXPECT_TRUE(decoded.may_contain("c", "d"));
+    EXPECT_TRUE(decoded.may_contain("a", "z"));
+    EXPECT_FALSE(decoded.may_contain("apz", "az"));
+    EXPECT_FALSE(decoded.may_contain("bandb", "bandz"));
+    EXPECT_FALSE(decoded.may_contain("d", "z"));
+    EXPECT_FALSE(decoded.may_contain("b", "a"));
+
+    // 随机键上不存在假阴性 空的短范围大部分能被排除
+    std::vector<std::string> random_keys;
+    std::mt19937 gen(7);
+    for (int i = 0; i < 2000; ++i) {
+        random_keys.push_back("key" + std::to_string(gen() % 1000000000));
+    }
+    std::sort(random_keys.begin(), random_keys.end());
+    RangeFilter random_filter;
+    for (const auto &key : random_keys) {
+        random_filter.add(key);
+    }
+    random_filter = RangeFilter::decode(random_filter.encode());
+    int false_positive = 0, empty_number = 0;
+    for (int i = 0; i < 2000; ++i) {
+        std::string lower = "key" + std::to_string(gen() % 1000000000);
+        std::string upper = lower + "5";
+        auto it = std::lower_bound(random_keys.begin(), random_keys.end(), lower);
+        if (it != random_keys.end() && *it <= upper) {
+            EXPECT_TRUE(random_filter.may_contain(lower, upper));
+        } else {
+            ++empty_number;
+            false_positive += random_filter.may_contain(lower, upper) ? 1 : 0;
+        }
+    }
+    EXPECT_LT(false_positive, empty_number / 4);
+
+    FilterSection section;
+    section.range_filter = std::make_shared<RangeFilter>(filter);
+    auto decoded_section = FilterSection::decode(section.encode());
+    ASSERT_NE(decoded_section.range_filter, nullptr);
+    EXPECT_EQ(decoded_section.key_filter, nullptr);
+    EXPECT_FALSE(decoded_section.range_filter->may_contain("apz", "az"));
+}
+
+TEST(RangeFilterTest, LongKeys) {
+    // 公共前缀超过64KB的键 长度以varint保存
+    std::string prefix(70000, 'k');
+    RangeFilter filter;
+    filter.add(prefix + "a");
+    filter.add(prefix + "b");
+    auto decoded = RangeFilter::decode(filter.encode());
+    EXPECT_EQ(decoded.get_entry_number(), 2);
+    EXPECT_TRUE(decoded.possibly_contain(prefix + "a"));
+    EXPECT_TRUE(decoded.possibly_contain(prefix + "b"));
+    EXPECT_FALSE(decoded.possibly_contain(prefix + "c"));
+    EXPECT_FALSE(decoded.may_contain(prefix, prefix));
+
+    // 旧格式的长度为2字节 没有varint标记
+    std::vector<uint8_t> legacy = {1, 2, 0, 0, 0};
+    for (auto [shared, unshared] : {std::make_pair<uint16_t, std::string>(0, "ab"),
+                                    std::make_pair<uint16_t, std::string>(1, "d")}) {
+        uint16_t unshared_length = unshared.size();
+        legacy.push_back(0);
+        legacy.insert(legacy.end(), reinterpret_cast<uint8_t *>(&shared), reinterpret_cast<uint8_t *>(&shared) + 2);
+        legacy.insert(legacy.end(), reinterpret_cast<uint8_t *>(&unshared_length),
+                      reinterpret_cast<uint8_t *>(&unshared_length) + 2);
+        legacy.insert(legacy.end(), unshared.begin(), unshared.end());
+    }
+    auto legacy_filter = RangeFilter::decode(legacy);
+    EXPECT_EQ(legacy_filter.get_entry_number(), 2);
+    EXPECT_TRUE(legacy_filter.possibly_contain("ab"));
+    EXPECT_TRUE(legacy_filter.possibly_contain("ad"));
+    EXPECT_FALSE(legacy_filter.possibly_contain("ac"));
+}
+
+TEST(CompressionTest, CompressionOperation) {
+    std::string json;
+    for (int i = 0; i < 200; ++i) {
+        json += "{\"id\":" + std::to_string(i) + ",\"name\":\"user" + std::to_string(i % 7) + "\",\"active\":true}";
+    }
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(json.data());
+
+    CompressionType type = CompressionType::LZ4;
+    std::vector<uint8_t> compressed;
+    ASSERT_TRUE(compress(type, data, json.size(), 0.875, compressed));
+    EXPECT_EQ(type, CompressionType::LZ4);
+    EXPECT_LT(compressed.size() * 3, json.size());
+    auto uncompressed = uncompress(type, compressed.data(), compressed.size());
+    EXPECT_EQ(std::string(uncompressed.begin(), uncompressed.end()), json);
+
+    // 系统没有libzstd时回退到LZ4 记录实际使用的算法
+    type = CompressionType::ZSTD;
+    ASSERT_TRUE(compress(type, data, json.size(), 0.875, compressed));
+    EXPECT_EQ(type, compression_supported(CompressionType::ZSTD) ? CompressionType::ZSTD : CompressionType::LZ4);
+    uncompressed = uncompress(type, compressed.data(), compressed.size());
+    EXPECT_EQ(std::string(uncompressed.begin(), uncompressed.end()), json);
+
+    // 随机数据压缩后不会变小 不保存压缩结果
+    std::mt19937 gen(42);
+    std::vector<uint8_t> random_data(4096);
+    for (auto &byte : random_data) {
+        byte = gen();
+    }
+    type = CompressionType::LZ4;
+    EXPECT_FALSE(compress(type, random_data.data(), random_data.size(), 0.875, compressed));
+    type = CompressionType::NONE;
+    EXPECT_FALSE(compress(type, data, json.size(), 0.875, compressed));
+
+    type = CompressionType::LZ4;
+    ASSERT_TRUE(compress(type, data, json.size(), 0.875, compressed));
+    compressed.resize(compressed.size() / 2);
+    EXPECT_THROW(uncompress(type, compressed.data(), compressed.size()), std::runtime_error);
+    EXPECT_EQ(to_compression_type("zstd"), CompressionType::ZSTD);
+    EXPECT_EQ(to_compression_type("none"), CompressionType::NONE);
+}
+
+TEST(CRC32CTest, CRC32COperation) {
+    EXPECT_EQ(crc32c("123456789", 9), 0xE3069283U);
+    EXPECT_EQ(crc32c_software("123456789", 9), 0xE3069283U);
+    EXPECT_EQ(crc32c("", 0), 0U);
+
+    // 硬件实现与查表实现结果一致 且支持分段计算
+    std::mt19937 gen(42);
+    std::vector<uint8_t> data(1000);
+    for (auto &byte : data) {
+        byte = gen();
+    }
+    for (size_t size : {1, 7, 8, 15, 64, 999, 1000}) {
+        EXPECT_EQ(crc32c(data.data(), size), crc32c_software(data.data(), size));
+        uint32_t crc = crc32c(data.data(), size / 3);
+        EXPECT_EQ(crc32c(data.data() + size / 3, size - size / 3, crc), crc32c(data.data(), size));
+    }
+    uint32_t crc = crc32c(data.data(), data.size());
+    data[500] ^= 0x10;
+    EXPECT_NE(crc32c(data.data(), data.size()), crc);
+}
+
+TEST(CodingTest, VarintOperation) {
+    std::vector<uint8_t> buffer;
+    std::vector<uint64_t> values = {0, 1, 127, 128, 16383, 16384, 65535, 65536, UINT32_MAX, UINT64_MAX};
+    for (uint64_t value : values) {
+        put_varint(buffer, value);
+    }
+    EXPECT_EQ(varint_length(127), 1U);
+    EXPECT_EQ(varint_length(128), 2U);
+    EXPECT_EQ(varint_length(UINT64_MAX), 10U);
+
+    const uint8_t *pointer = buffer.data();
+    const uint8_t *limit = buffer.data() + buffer.size();
+    for (uint64_t value : values) {
+        uint64_t decoded;
+        pointer = decode_varint(pointer, limit, decoded);
+        ASSERT_NE(pointer, nullptr);
+        EXPECT_EQ(decoded, value);
+    }
+    EXPECT_EQ(pointer, limit);
+
+    // 截断或超过10字节的数据解析失败
+    uint64_t decoded;
+    EXPECT_EQ(decode_varint(buffer.data() + buffer.size() - 5, limit - 1, decoded), nullptr);
+    std::vector<uint8_t> overflow(11, 0xFF);
+    EXPECT_EQ(decode_varint(overflow.data(), overflow.data() + overflow.size(), decoded), nullptr);
+
+    // zigzag映射后绝对值较小的负数只占1字节
+    EXPECT_EQ(zigzag_encode(0), 0U);
+    EXPECT_EQ(zigzag_encode(-1), 1U);
+    EXPECT_EQ(zigzag_encode(1), 2U);
+    EXPECT_EQ(zigzag_encode(-64), 127U);
+    for (int64_t value : {int64_t{0}, int64_t{-1}, int64_t{12345}, int64_t{-12345}, INT64_MAX, INT64_MIN}) {
+        EXPECT_EQ(zigzag_decode(zigzag_encode(value)), value);
+    }
+}
+
+TEST(CountMinSketchTest, CountMinSketchOperation) {
+    CountMinSketch sketch(1024);
+
+    for (uint64_t i = 0; i < 10; ++i) {
+        for (uint64_t j = 0; j <= i; ++j) {
+            sketch.increment(i);
+        }
+    }
+    for (uint64_t i = 0; i < 10; ++i) {
+        EXPECT_GE(sketch.estimate(i), i + 1);
+    }
+    for (int i = 0; i < 20; ++i) {
+        sketch.increment(42);
+    }
+    EXPECT_EQ(sketch.estimate(42), 15);
+
+    sketch.reset();
+    EXPECT_EQ(sketch.estimate(42), 7);
+
+    sketch.clear();
+    EXPECT_EQ(sketch.estimate(42), 0);
 }
 
 TEST(TomlConfigTest, TomleConfigOperation) {